@@ -0,0 +1,87 @@
+#include "Bench.h"
+
+#include <SDL.h>
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+#if defined(_WIN32)
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+  #include <psapi.h>
+#else
+  #include <sys/resource.h>
+#endif
+
+using json = nlohmann::json;
+
+bool BenchReport::enabled(const std::string& name) const {
+  return opt_.filter.empty() || name.find(opt_.filter) != std::string::npos;
+}
+
+void BenchReport::add(BenchResult r) {
+  std::printf("%-36s %10llu ops %10.3f ms %12.1f ns/op",
+              r.name.c_str(), (unsigned long long)r.iterations, r.totalMs, r.nsPerOp());
+  for (const auto& [k, v] : r.metrics) std::printf("  %s=%.6g", k.c_str(), v);
+  std::printf("\n");
+  std::fflush(stdout);
+  results_.push_back(std::move(r));
+}
+
+bool BenchReport::writeJson() const {
+  json j;
+  j["version"] = 1;
+  j["timestamp"] = (int64_t)std::time(nullptr);
+  j["platform"] = SDL_GetPlatform();
+  j["quick"] = opt_.quick;
+#if defined(NDEBUG)
+  j["build"] = "release";
+#else
+  j["build"] = "debug";
+#endif
+
+  json arr = json::array();
+  for (const auto& r : results_) {
+    json jr;
+    jr["name"] = r.name;
+    jr["iterations"] = r.iterations;
+    jr["total_ms"] = r.totalMs;
+    jr["ns_per_op"] = r.nsPerOp();
+    json m = json::object();
+    for (const auto& [k, v] : r.metrics) m[k] = v;
+    jr["metrics"] = m;
+    arr.push_back(jr);
+  }
+  j["results"] = arr;
+
+  std::ofstream f(opt_.outPath, std::ios::binary);
+  if (!f) return false;
+  f << j.dump(2) << "\n";
+  return (bool)f;
+}
+
+namespace Bench {
+
+uint64_t peakRssKb() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS pmc{};
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+  return (uint64_t)pmc.PeakWorkingSetSize / 1024;
+#else
+  rusage ru{};
+  if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+  #if defined(__APPLE__)
+    return (uint64_t)ru.ru_maxrss / 1024; // bytes on macOS
+  #else
+    return (uint64_t)ru.ru_maxrss;        // KiB on Linux
+  #endif
+#endif
+}
+
+static volatile uint64_t g_sink = 0;
+
+void sink(uint64_t v) { g_sink = g_sink + v; }
+
+} // namespace Bench
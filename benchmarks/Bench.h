@@ -0,0 +1,65 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal benchmark harness: each benchmark times a loop itself and reports
+// one BenchResult; BenchReport collects them and writes JSON.
+
+struct BenchOptions {
+  std::string outPath{"bench-results.json"};
+  std::string filter;  // run only benchmarks whose name contains this
+  bool quick{false};   // smaller inputs / fewer iterations (CI smoke runs)
+};
+
+struct BenchResult {
+  std::string name;
+  uint64_t iterations{0};  // operations timed (steps, ticks, buffers, frames...)
+  double totalMs{0.0};
+  std::vector<std::pair<std::string, double>> metrics; // extra numbers
+
+  double nsPerOp() const { return iterations ? totalMs * 1e6 / (double)iterations : 0.0; }
+  void metric(std::string key, double v) { metrics.emplace_back(std::move(key), v); }
+};
+
+class BenchReport {
+public:
+  explicit BenchReport(BenchOptions opt) : opt_(std::move(opt)) {}
+
+  const BenchOptions& options() const { return opt_; }
+  bool enabled(const std::string& name) const;
+
+  void add(BenchResult r);
+  bool writeJson() const;
+
+private:
+  BenchOptions opt_;
+  std::vector<BenchResult> results_;
+};
+
+class BenchTimer {
+public:
+  BenchTimer() : t0_(std::chrono::steady_clock::now()) {}
+  double elapsedMs() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0_).count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point t0_;
+};
+
+namespace Bench {
+  // process peak resident set size in KiB (0 if unsupported)
+  uint64_t peakRssKb();
+
+  // keep the optimizer from dropping a computed value
+  void sink(uint64_t v);
+
+  // groups, see Bench*.cpp
+  void runRuntime(BenchReport& report);
+  void runSerialization(BenchReport& report);
+  void runAudio(BenchReport& report);
+  void runRenderer(BenchReport& report);
+}
@@ -0,0 +1,91 @@
+#include "Bench.h"
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include "audio/AudioEngine.h"
+
+namespace {
+
+void put16(std::ofstream& f, uint16_t v) { f.put((char)(v & 0xff)); f.put((char)(v >> 8)); }
+void put32(std::ofstream& f, uint32_t v) { put16(f, (uint16_t)(v & 0xffff)); put16(f, (uint16_t)(v >> 16)); }
+
+// 16-bit stereo PCM sine, in the device format so no conversion is involved
+bool writeSineWav(const std::string& path, int rate, float seconds) {
+  std::ofstream f(path, std::ios::binary);
+  if (!f) return false;
+
+  const uint32_t frames = (uint32_t)(rate * seconds);
+  const uint32_t dataBytes = frames * 4;
+
+  f.write("RIFF", 4); put32(f, 36 + dataBytes); f.write("WAVE", 4);
+  f.write("fmt ", 4); put32(f, 16);
+  put16(f, 1);                      // PCM
+  put16(f, 2);                      // channels
+  put32(f, (uint32_t)rate);
+  put32(f, (uint32_t)rate * 4);     // byte rate
+  put16(f, 4);                      // block align
+  put16(f, 16);                     // bits per sample
+  f.write("data", 4); put32(f, dataBytes);
+
+  for (uint32_t i = 0; i < frames; ++i) {
+    int16_t s = (int16_t)(8000.0 * std::sin(2.0 * 3.14159265358979 * 440.0 * i / rate));
+    put16(f, (uint16_t)s);
+    put16(f, (uint16_t)s);
+  }
+  return (bool)f;
+}
+
+} // namespace
+
+namespace Bench {
+
+void runAudio(BenchReport& report) {
+  const std::string name = "audio.mix.64_voices";
+  if (!report.enabled(name)) return;
+
+  namespace fs = std::filesystem;
+  const fs::path wav = fs::temp_directory_path() / "scratchy-bench-sine.wav";
+
+  AudioEngine& audio = AudioEngine::instance();
+  if (!audio.init(false)) return;
+  const int rate = audio.deviceSpec().freq;
+  if (!writeSineWav(wav.string(), rate, 10.0f)) return;
+
+  const int kVoices = 64;
+  const int kFrames = 1024;  // matches the device buffer size requested by init()
+  const int rounds = report.options().quick ? 10 : 100;
+  const int buffersPerRound = 100; // ~2.3 s of audio; every voice outlives it
+  std::vector<Uint8> buf((size_t)kFrames * 4);
+
+  BenchResult r;
+  r.name = name;
+  for (int round = 0; round < rounds; ++round) {
+    audio.stopAll();
+    for (int v = 0; v < kVoices; ++v) {
+      audio.playWav(wav.string(), 0.5f, (float)(v % 25 - 12)); // -12..+12 semitones
+    }
+
+    BenchTimer t;
+    for (int i = 0; i < buffersPerRound; ++i) audio.mix(buf.data(), (int)buf.size());
+    r.totalMs += t.elapsedMs();
+    r.iterations += (uint64_t)buffersPerRound;
+    sink(buf[0]);
+  }
+  audio.shutdown();
+
+  r.metric("voices", kVoices);
+  r.metric("frames_per_buffer", kFrames);
+  // share of the real-time budget one buffer represents (1.0 = just keeps up)
+  r.metric("realtime_load", (r.nsPerOp() * 1e-9) / ((double)kFrames / (double)rate));
+  report.add(std::move(r));
+
+  std::error_code ec;
+  fs::remove(wav, ec);
+}
+
+} // namespace Bench
@@ -0,0 +1,43 @@
+// scratchy-bench: interpreter, serializer, mixer and renderer microbenchmarks.
+//
+//   scratchy-bench [--out FILE] [--filter SUBSTR] [--quick]
+//
+// Results are printed and written to FILE (default bench-results.json) so
+// runs can be compared between releases.
+
+#include <cstdio>
+#include <cstring>
+
+#include "Bench.h"
+#include "core/Logger.h"
+
+int main(int argc, char** argv) {
+  BenchOptions opt;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      opt.outPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      opt.filter = argv[++i];
+    } else if (std::strcmp(argv[i], "--quick") == 0) {
+      opt.quick = true;
+    } else {
+      std::fprintf(stderr, "usage: scratchy-bench [--out FILE] [--filter SUBSTR] [--quick]\n");
+      return 1;
+    }
+  }
+
+  Logger::init();
+  BenchReport report(opt);
+
+  Bench::runRuntime(report);
+  Bench::runSerialization(report);
+  Bench::runAudio(report);
+  Bench::runRenderer(report);
+
+  if (!report.writeJson()) {
+    std::fprintf(stderr, "scratchy-bench: could not write '%s'\n", opt.outPath.c_str());
+    return 1;
+  }
+  std::printf("results written to %s\n", opt.outPath.c_str());
+  return 0;
+}
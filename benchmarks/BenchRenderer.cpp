@@ -0,0 +1,85 @@
+#include "Bench.h"
+#include "SyntheticProjects.h"
+
+#include <filesystem>
+#include <system_error>
+
+#include "renderer/Renderer2D.h"
+#include "renderer/TextureCache.h"
+
+namespace {
+
+// 64x64 checker costume written with SDL_SaveBMP (IMG_Load reads BMP)
+bool writeCostumeBmp(const std::string& path) {
+  SDL_Surface* s = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_RGBA32);
+  if (!s) return false;
+  for (int y = 0; y < 64; ++y) {
+    Uint32* row = (Uint32*)((Uint8*)s->pixels + y * s->pitch);
+    for (int x = 0; x < 64; ++x) {
+      bool on = ((x / 8) + (y / 8)) % 2 == 0;
+      row[x] = SDL_MapRGBA(s->format, on ? 240 : 40, 140, on ? 40 : 240, 255);
+    }
+  }
+  bool ok = SDL_SaveBMP(s, path.c_str()) == 0;
+  SDL_FreeSurface(s);
+  return ok;
+}
+
+// drawStage into a software renderer backed by a plain surface: no window
+void drawFrames(BenchReport& report, const std::string& name, const Project& project, int frames) {
+  if (!report.enabled(name)) return;
+
+  SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 960, 720, 32, SDL_PIXELFORMAT_RGBA32);
+  if (!target) return;
+  SDL_Renderer* ren = SDL_CreateSoftwareRenderer(target);
+  if (!ren) { SDL_FreeSurface(target); return; }
+
+  {
+    TextureCache cache(ren);
+    Renderer2D renderer(ren, &cache);
+    const SDL_FRect stageRect{0.0f, 0.0f, 960.0f, 720.0f};
+
+    renderer.drawStage(project, stageRect); // warm the texture cache
+
+    BenchResult r;
+    r.name = name;
+    BenchTimer t;
+    for (int i = 0; i < frames; ++i) {
+      SDL_SetRenderDrawColor(ren, 0, 0, 0, 255);
+      SDL_RenderClear(ren);
+      renderer.drawStage(project, stageRect);
+      SDL_RenderPresent(ren);
+    }
+    r.totalMs = t.elapsedMs();
+    r.iterations = (uint64_t)frames;
+    r.metric("sprites", (double)project.sprites().size());
+    report.add(std::move(r));
+  }
+
+  SDL_DestroyRenderer(ren);
+  SDL_FreeSurface(target);
+}
+
+} // namespace
+
+namespace Bench {
+
+void runRenderer(BenchReport& report) {
+  const int frames = report.options().quick ? 20 : 200;
+  Project project;
+  Synthetic::manySprites(project, 1000);
+
+  drawFrames(report, "renderer.draw_stage.1k_placeholder", project, frames);
+
+  namespace fs = std::filesystem;
+  const fs::path bmp = fs::temp_directory_path() / "scratchy-bench-costume.bmp";
+  if (!writeCostumeBmp(bmp.string())) return;
+
+  Synthetic::setCostumes(project, bmp.string());
+  drawFrames(report, "renderer.draw_stage.1k_textured", project, frames);
+
+  std::error_code ec;
+  fs::remove(bmp, ec);
+}
+
+} // namespace Bench
@@ -0,0 +1,269 @@
+#include "Bench.h"
+#include "SyntheticProjects.h"
+
+#include <climits>
+
+#include "audio/AudioSink.h"
+#include "model/CollisionMask.h"
+#include "runtime/Compiler.h"
+#include "runtime/Condition.h"
+#include "runtime/RunContext.h"
+#include "runtime/Runtime.h"
+#include "runtime/ScriptRunner.h"
+#include "runtime/SensingIndex.h"
+
+namespace {
+
+NullAudioSink g_audio;
+RunContext benchContext() {
+  RunContext ctx;
+  ctx.audio = &g_audio; // no sensing index: rough collision fallbacks
+  return ctx;
+}
+RunContext g_ctx = benchContext();
+
+// Runs the sprite's first script to completion on a single warp runner
+// (tick() is a thin loop over stepOnce), `rounds` times.
+BenchResult stepScript(const std::string& name, Project& project, int rounds) {
+  Sprite& sp = project.sprites().front();
+  auto prog = Compiler::compileScript(project, sp, sp.scripts.front());
+
+  BenchResult r;
+  r.name = name;
+  BenchTimer t;
+  for (int i = 0; i < rounds; ++i) {
+    ScriptRunner runner;
+    runner.setWarp(true);
+    runner.start(project, prog, g_ctx);
+    while (!runner.isFinished()) {
+      int steps = 0;
+      runner.tick(project, INT_MAX, &steps, nullptr, nullptr);
+      r.iterations += (uint64_t)steps;
+    }
+  }
+  r.totalMs = t.elapsedMs();
+  r.metric("instructions", (double)prog->code.size());
+  r.metric("rounds", rounds);
+  return r;
+}
+
+// Full Runtime::tick at 60 Hz with the safety pauses lifted, so the timing
+// covers every runner each tick. The watchdog keeps its default limit: a
+// project it pauses reports paused_with_error.
+BenchResult tickRuntime(const std::string& name, Project& project, int ticks, bool parallel = false,
+                        bool profiled = false, bool turbo = false) {
+  Runtime rt;
+  rt.safety().maxTickMillis = 1000;
+  rt.safety().maxTotalStepsPerTick = 500000;
+  rt.setTurbo(turbo);
+  if (parallel) rt.setParallel(true);
+  if (profiled) rt.setProfiling(true);
+  rt.startGreenFlag(project);
+
+  BenchResult r;
+  r.name = name;
+  BenchTimer t;
+  for (int i = 0; i < ticks && rt.isRunning() && !rt.isPaused(); ++i) {
+    rt.tick(project, 1.0f / 60.0f);
+    ++r.iterations;
+  }
+  r.totalMs = t.elapsedMs();
+  r.metric("sprites", (double)project.sprites().size());
+  r.metric("steps_per_tick", r.iterations ? (double)rt.totalSteps() / (double)r.iterations : 0.0);
+  if (!rt.lastError().empty()) r.metric("paused_with_error", 1.0);
+  if (parallel) r.metric("threads", (double)WorkerPool::defaultThreads() + 1.0);
+  if (profiled) r.metric("profiled_blocks", (double)rt.profiler().blocks().size());
+  return r;
+}
+
+// 64x64 costume whose opaque part is a disc
+CollisionMask discMask() {
+  CollisionMask m;
+  m.width = m.height = 64;
+  m.wordsPerRow = 1;
+  m.bits.assign(64, 0);
+  for (int y = 0; y < 64; ++y) {
+    for (int x = 0; x < 64; ++x) {
+      float dx = (float)x - 31.5f, dy = (float)y - 31.5f;
+      if (dx*dx + dy*dy <= 32.0f * 32.0f) m.bits[(size_t)y] |= (uint64_t)1 << x;
+    }
+  }
+  return m;
+}
+
+// SensingIndex::touching between masked sprites that turn every round, so
+// footprints are rebuilt as often as in a game where everything spins
+BenchResult touchingMasked(const std::string& name, Project& project, int rounds, float turnPerRound) {
+  CollisionMaskCache masks;
+  masks.put("bench-disc", discMask());
+  Synthetic::setCostumes(project, "bench-disc");
+  for (auto& sp : project.sprites()) sp.sizePercent = 300.0f; // 90 units: plenty of overlaps
+
+  SensingIndex index;
+  index.setMasks(&masks);
+  index.rebuild(project);
+
+  auto& sprites = project.sprites();
+  const size_t n = sprites.size();
+  uint64_t hits = 0;
+
+  BenchResult r;
+  r.name = name;
+  BenchTimer t;
+  for (int round = 0; round < rounds; ++round) {
+    for (size_t i = 0; i < n; ++i) {
+      sprites[i].directionDeg += turnPerRound;
+      for (size_t k = 1; k <= 4; ++k) hits += index.touching(project, i, sprites[(i + k) % n].id) ? 1 : 0;
+    }
+  }
+  r.totalMs = t.elapsedMs();
+  r.iterations = (uint64_t)rounds * n * 4;
+  r.metric("sprites", (double)n);
+  r.metric("hit_rate", r.iterations ? (double)hits / (double)r.iterations : 0.0);
+  return r;
+}
+
+// press a key, run the started scripts to completion, repeat
+BenchResult keyDispatch(const std::string& name, Project& project, int presses) {
+  Runtime rt;
+  uint64_t started = 0;
+
+  BenchResult r;
+  r.name = name;
+  BenchTimer t;
+  for (int i = 0; i < presses; ++i) {
+    rt.keyPressed(project, (SDL_Scancode)(SDL_SCANCODE_A + i % 26));
+    while (rt.isRunning()) {
+      rt.tick(project, 1.0f / 60.0f);
+      ++started;
+    }
+  }
+  r.totalMs = t.elapsedMs();
+  r.iterations = (uint64_t)presses;
+  r.metric("ticks_per_press", (double)started / (double)presses);
+  r.metric("steps", (double)rt.totalSteps());
+  return r;
+}
+
+} // namespace
+
+namespace Bench {
+
+void runRuntime(BenchReport& report) {
+  const bool quick = report.options().quick;
+  Project project;
+
+  if (report.enabled("runtime.step.long_script")) {
+    Synthetic::longScript(project, 10000);
+    report.add(stepScript("runtime.step.long_script", project, quick ? 10 : 100));
+  }
+
+  if (report.enabled("runtime.step.nested_repeats")) {
+    Synthetic::nestedRepeats(project, 3, quick ? 20 : 50);
+    report.add(stepScript("runtime.step.nested_repeats", project, quick ? 2 : 10));
+  }
+
+  if (report.enabled("runtime.tick.1k_sprites")) {
+    Synthetic::manySprites(project, 1000);
+    report.add(tickRuntime("runtime.tick.1k_sprites", project, quick ? 30 : 300));
+  }
+
+  if (report.enabled("runtime.tick.1k_sprites.parallel")) {
+    Synthetic::manySprites(project, 1000);
+    report.add(tickRuntime("runtime.tick.1k_sprites.parallel", project, quick ? 30 : 300, true));
+  }
+
+  // every forever loop runs as often as turboTickMillis allows; none of
+  // them may trip the watchdog
+  if (report.enabled("runtime.tick.1k_sprites.turbo")) {
+    Synthetic::manySprites(project, 1000);
+    report.add(tickRuntime("runtime.tick.1k_sprites.turbo", project, quick ? 30 : 300, false, false, true));
+  }
+
+  // profiling overhead: compare with runtime.tick.1k_sprites
+  if (report.enabled("runtime.tick.1k_sprites.profiled")) {
+    Synthetic::manySprites(project, 1000);
+    report.add(tickRuntime("runtime.tick.1k_sprites.profiled", project, quick ? 30 : 300, false, true));
+  }
+
+  if (report.enabled("runtime.tick.wait_until_storm")) {
+    Synthetic::waitUntilStorm(project, 200, 10);
+    report.add(tickRuntime("runtime.tick.wait_until_storm", project, quick ? 30 : 300));
+  }
+
+  if (report.enabled("runtime.tick.touching_swarm")) {
+    Synthetic::touchingSwarm(project, 1000);
+    report.add(tickRuntime("runtime.tick.touching_swarm", project, quick ? 30 : 300));
+  }
+
+  if (report.enabled("runtime.tick.touching_swarm.parallel")) {
+    Synthetic::touchingSwarm(project, 1000);
+    report.add(tickRuntime("runtime.tick.touching_swarm.parallel", project, quick ? 30 : 300, true));
+  }
+
+  if (report.enabled("runtime.tick.clone_churn")) {
+    Synthetic::cloneChurn(project, 250);
+    BenchResult r = tickRuntime("runtime.tick.clone_churn", project, quick ? 30 : 300);
+    r.metric("clones_per_tick", (double)project.sprites().size());
+    report.add(std::move(r));
+  }
+
+  if (report.enabled("events.key_dispatch.1k_sprites")) {
+    Synthetic::keyHats(project, 1000, 2);
+    report.add(keyDispatch("events.key_dispatch.1k_sprites", project, quick ? 200 : 2000));
+  }
+
+  if (report.enabled("collision.touching.masked_static")) {
+    Synthetic::touchingSwarm(project, 50);
+    report.add(touchingMasked("collision.touching.masked_static", project, quick ? 200 : 2000, 0.0f));
+  }
+
+  if (report.enabled("collision.touching.masked_spinning")) {
+    Synthetic::touchingSwarm(project, 50);
+    report.add(touchingMasked("collision.touching.masked_spinning", project, quick ? 200 : 2000, 7.0f));
+  }
+
+  // evalCondition per condition kind, against a 1k-sprite project so sprite
+  // targets sit deep in the sprite list
+  static const char* kConditions[][2] = {
+    {"true",           "true"},
+    {"touching_edge",  "touching edge"},
+    {"touching_mouse", "touching mouse"},
+    {"touching_sprite","touching Sprite900"},
+    {"key",            "key space"},
+    {"mouse_down",     "mouse down"},
+    {"distance_sprite","distance to Sprite900 < 50"},
+    {"distance_mouse", "distance to mouse > 5"},
+    {"mouse_x",        "mouse x > 0"},
+  };
+
+  bool anyCond = false;
+  for (const auto& c : kConditions) anyCond |= report.enabled(std::string("condition.eval.") + c[0]);
+  if (!anyCond) return;
+
+  Synthetic::manySprites(project, 1000);
+  project.setMouseWorld(10.0f, 20.0f, true);
+  const Sprite& self = project.sprites().front();
+  const uint64_t n = quick ? 100000 : 2000000;
+  ScriptRunner runner;
+
+  for (const auto& c : kConditions) {
+    std::string name = std::string("condition.eval.") + c[0];
+    if (!report.enabled(name)) continue;
+
+    Condition cond = Conditions::compile(c[1]);
+    Conditions::resolve(cond, project);
+
+    BenchResult r;
+    r.name = name;
+    uint64_t hits = 0;
+    BenchTimer t;
+    for (uint64_t i = 0; i < n; ++i) hits += runner.evalCondition(project, self, cond) ? 1 : 0;
+    r.totalMs = t.elapsedMs();
+    r.iterations = n;
+    sink(hits);
+    report.add(std::move(r));
+  }
+}
+
+} // namespace Bench
@@ -0,0 +1,78 @@
+#include "Bench.h"
+#include "SyntheticProjects.h"
+
+#include <filesystem>
+#include <system_error>
+
+#include "core/Serialization.h"
+
+namespace {
+
+size_t blockCount(const Project& project) {
+  size_t n = 0;
+  for (const auto& sp : project.sprites()) n += sp.blocks.size();
+  return n;
+}
+
+void saveLoad(BenchReport& report, const std::string& tag, Project& project, int rounds) {
+  namespace fs = std::filesystem;
+  const fs::path path = fs::temp_directory_path() / ("scratchy-bench-" + tag + ".json");
+  const double blocks = (double)blockCount(project);
+
+  const std::string saveName = "serialization.save." + tag;
+  if (report.enabled(saveName) || report.enabled("serialization.load." + tag)) {
+    BenchResult r;
+    r.name = saveName;
+    uint64_t rssBefore = Bench::peakRssKb();
+    BenchTimer t;
+    for (int i = 0; i < rounds; ++i) {
+      if (!Serialization::saveToFile(project, path.string())) return;
+    }
+    r.totalMs = t.elapsedMs();
+    r.iterations = (uint64_t)rounds;
+    std::error_code ec;
+    r.metric("file_bytes", (double)fs::file_size(path, ec));
+    r.metric("blocks", blocks);
+    r.metric("peak_rss_kb", (double)Bench::peakRssKb());
+    r.metric("peak_rss_growth_kb", (double)(Bench::peakRssKb() - rssBefore));
+    if (report.enabled(saveName)) report.add(std::move(r));
+  }
+
+  const std::string loadName = "serialization.load." + tag;
+  if (report.enabled(loadName)) {
+    BenchResult r;
+    r.name = loadName;
+    uint64_t rssBefore = Bench::peakRssKb();
+    BenchTimer t;
+    for (int i = 0; i < rounds; ++i) {
+      Project loaded;
+      if (!Serialization::loadFromFile(loaded, path.string())) return;
+    }
+    r.totalMs = t.elapsedMs();
+    r.iterations = (uint64_t)rounds;
+    r.metric("blocks", blocks);
+    r.metric("peak_rss_kb", (double)Bench::peakRssKb());
+    r.metric("peak_rss_growth_kb", (double)(Bench::peakRssKb() - rssBefore));
+    report.add(std::move(r));
+  }
+
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+}
+
+} // namespace
+
+namespace Bench {
+
+void runSerialization(BenchReport& report) {
+  const bool quick = report.options().quick;
+  Project project;
+
+  Synthetic::longScript(project, 10000);
+  saveLoad(report, "long_script", project, quick ? 2 : 10);
+
+  Synthetic::manySprites(project, 1000);
+  saveLoad(report, "1k_sprites", project, quick ? 2 : 10);
+}
+
+} // namespace Bench
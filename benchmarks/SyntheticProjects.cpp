@@ -0,0 +1,167 @@
+#include "SyntheticProjects.h"
+
+namespace {
+
+void clear(Project& project) {
+  project.resetToDefault();
+  project.clearSprites();
+}
+
+Sprite& addSprite(Project& project, int index) {
+  Sprite s;
+  s.id = project.allocSpriteId();
+  s.name = "Sprite" + std::to_string(index + 1);
+  // spread over the stage so touching/distance checks see varied inputs
+  s.x = -220.0f + (float)((index * 37) % 440);
+  s.y = -160.0f + (float)((index * 53) % 320);
+  s.directionDeg = (float)((index * 29) % 360);
+  return project.addSprite(std::move(s));
+}
+
+// detached block (appendToChain on an empty chain), then linked after `tail`;
+// keeps building long stacks O(1) per block
+int appendAfter(Project& project, Sprite& sp, int tail, BlockType type) {
+  int head = -1;
+  int id = project.appendToChain(sp, head, type, 0.0f, 0.0f);
+  project.linkAfter(sp, tail, id);
+  return id;
+}
+
+int addChild(Project& project, Sprite& sp, int parentId, BlockType type) {
+  return project.appendToChain(sp, project.findBlock(sp, parentId)->childHeadId, type, 0.0f, 0.0f, parentId);
+}
+
+void setArg(Project& project, Sprite& sp, int blockId, size_t index, const std::string& v) {
+  project.setBlockArg(*project.findBlock(sp, blockId), index, v);
+}
+
+int hatOf(Project& project, Sprite& sp, int scriptId) {
+  return project.findScript(sp, scriptId)->headBlockId;
+}
+
+} // namespace
+
+namespace Synthetic {
+
+void longScript(Project& project, int blocks) {
+  static const BlockType kCycle[] = {
+    BlockType::MoveSteps, BlockType::TurnRight, BlockType::ChangeXBy,
+    BlockType::ChangeYBy, BlockType::SetVolumeTo, BlockType::TurnLeft,
+    BlockType::GoToXY, BlockType::SetPitchTo,
+  };
+  const int cycle = (int)(sizeof(kCycle) / sizeof(kCycle[0]));
+
+  clear(project);
+  Sprite& sp = addSprite(project, 0);
+  int sid = project.createScript(sp, 0.0f, 0.0f, BlockType::WhenGreenFlag);
+
+  int tail = hatOf(project, sp, sid);
+  for (int i = 0; i < blocks; ++i) {
+    tail = appendAfter(project, sp, tail, kCycle[i % cycle]);
+  }
+}
+
+void manySprites(Project& project, int sprites) {
+  clear(project);
+  for (int i = 0; i < sprites; ++i) {
+    Sprite& sp = addSprite(project, i);
+    int sid = project.createScript(sp, 0.0f, 0.0f, BlockType::WhenGreenFlag);
+    int forever = project.appendBlockToScript(sp, sid, BlockType::Forever);
+    int move = addChild(project, sp, forever, BlockType::MoveSteps);
+    setArg(project, sp, move, 0, std::to_string(1 + i % 5));
+    addChild(project, sp, forever, BlockType::TurnRight);
+    int ifEdge = addChild(project, sp, forever, BlockType::IfThen);
+    addChild(project, sp, ifEdge, BlockType::GoToXY);
+  }
+}
+
+void nestedRepeats(Project& project, int depth, int count) {
+  clear(project);
+  Sprite& sp = addSprite(project, 0);
+  int sid = project.createScript(sp, 0.0f, 0.0f, BlockType::WhenGreenFlag);
+
+  int rep = project.appendBlockToScript(sp, sid, BlockType::Repeat);
+  setArg(project, sp, rep, 0, std::to_string(count));
+  for (int d = 1; d < depth; ++d) {
+    rep = addChild(project, sp, rep, BlockType::Repeat);
+    setArg(project, sp, rep, 0, std::to_string(count));
+  }
+  int change = addChild(project, sp, rep, BlockType::ChangeXBy);
+  setArg(project, sp, change, 0, "1");
+}
+
+void waitUntilStorm(Project& project, int sprites, int waitersPerSprite) {
+  clear(project);
+  for (int i = 0; i < sprites; ++i) addSprite(project, i);
+
+  auto& all = project.sprites();
+  for (int i = 0; i < sprites; ++i) {
+    Sprite& sp = all[(size_t)i];
+    const std::string target = all[(size_t)((i + 1) % sprites)].name;
+    for (int w = 0; w < waitersPerSprite; ++w) {
+      int sid = project.createScript(sp, 0.0f, 0.0f, BlockType::WhenGreenFlag);
+      int wait = project.appendBlockToScript(sp, sid, BlockType::WaitUntil);
+      setArg(project, sp, wait, 0, "distance to " + target + " < -1");
+      project.appendBlockToScript(sp, sid, BlockType::Say);
+    }
+  }
+}
+
+void touchingSwarm(Project& project, int sprites) {
+  clear(project);
+  for (int i = 0; i < sprites; ++i) addSprite(project, i);
+
+  auto& all = project.sprites();
+  for (int i = 0; i < sprites; ++i) {
+    Sprite& sp = all[(size_t)i];
+    const std::string target = all[(size_t)((i + 1) % sprites)].name;
+    int sid = project.createScript(sp, 0.0f, 0.0f, BlockType::WhenGreenFlag);
+    int forever = project.appendBlockToScript(sp, sid, BlockType::Forever);
+    int move = addChild(project, sp, forever, BlockType::MoveSteps);
+    setArg(project, sp, move, 0, std::to_string(1 + i % 5));
+    int ifTouch = addChild(project, sp, forever, BlockType::IfThen);
+    setArg(project, sp, ifTouch, 0, "touching " + target);
+    addChild(project, sp, ifTouch, BlockType::TurnRight);
+  }
+}
+
+void keyHats(Project& project, int sprites, int hatsPerSprite) {
+  clear(project);
+  int n = 0;
+  for (int i = 0; i < sprites; ++i) {
+    Sprite& sp = addSprite(project, i);
+    for (int h = 0; h < hatsPerSprite; ++h, ++n) {
+      int sid = project.createScript(sp, 0.0f, 0.0f, BlockType::WhenKeyPressed);
+      setArg(project, sp, hatOf(project, sp, sid), 0, std::string(1, (char)('a' + n % 26)));
+      int change = project.appendBlockToScript(sp, sid, BlockType::ChangeXBy);
+      setArg(project, sp, change, 0, "1");
+    }
+  }
+}
+
+void cloneChurn(Project& project, int sprites) {
+  clear(project);
+  for (int i = 0; i < sprites; ++i) {
+    Sprite& sp = addSprite(project, i);
+    int sid = project.createScript(sp, 0.0f, 0.0f, BlockType::WhenGreenFlag);
+    int forever = project.appendBlockToScript(sp, sid, BlockType::Forever);
+    addChild(project, sp, forever, BlockType::CreateCloneOf);
+
+    int cid = project.createScript(sp, 0.0f, 0.0f, BlockType::WhenIStartAsClone);
+    project.appendBlockToScript(sp, cid, BlockType::MoveSteps);
+    project.appendBlockToScript(sp, cid, BlockType::TurnRight);
+    project.appendBlockToScript(sp, cid, BlockType::DeleteThisClone);
+  }
+}
+
+void setCostumes(Project& project, const std::string& costumePath) {
+  for (auto& sp : project.sprites()) {
+    Costume c;
+    c.name = "costume1";
+    c.imagePath = costumePath;
+    sp.costumes = {c};
+    sp.currentCostume = 0;
+  }
+}
+
+} // namespace Synthetic
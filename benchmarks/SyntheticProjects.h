@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+
+#include "core/Project.h"
+
+// Generated projects for benchmarks. Every generator starts from an empty
+// project (no default sprite) and only uses Project's editing helpers, so the
+// result looks like something built in the editor.
+namespace Synthetic {
+  // one sprite, green flag + `blocks` straight-line motion/looks blocks
+  void longScript(Project& project, int blocks);
+
+  // `sprites` sprites, each running
+  //   forever { move; turn; if touching edge then go to x:0 y:0 }
+  void manySprites(Project& project, int sprites);
+
+  // `depth` Repeat blocks nested inside each other, `count` iterations each,
+  // with change x by 1 in the innermost body
+  void nestedRepeats(Project& project, int depth, int count);
+
+  // `sprites` sprites with `waitersPerSprite` scripts each blocked on a
+  // never-true "wait until distance to <next sprite> < -1"
+  void waitUntilStorm(Project& project, int sprites, int waitersPerSprite);
+
+  // `sprites` sprites, each running
+  //   forever { move; if touching <next sprite> then turn }
+  void touchingSwarm(Project& project, int sprites);
+
+  // `sprites` sprites with `hatsPerSprite` "when <letter> key pressed"
+  // scripts each (letters cycle a..z), every one a single change x by 1
+  void keyHats(Project& project, int sprites, int hatsPerSprite);
+
+  // `sprites` sprites, each running
+  //   forever { create clone of myself }
+  // with "when I start as a clone: move; turn; delete this clone", so every
+  // tick spawns and deletes one clone per sprite
+  void cloneChurn(Project& project, int sprites);
+
+  // gives every sprite `costumePath` as its only costume
+  void setCostumes(Project& project, const std::string& costumePath);
+}
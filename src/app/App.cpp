@@ -7,9 +7,10 @@
 #include "backends/imgui_impl_sdlrenderer2.h"
 #include <SDL.h>
 
+#include "audio/AudioEngine.h"
 #include "core/Logger.h"
 #include "core/Time.h"
-#include "core/Watchdog.h"
+#include "core/Trace.h"
 #include "ui/MainDockspace.h"
 #include "renderer/TextureCache.h"
 #include "renderer/Renderer2D.h"
@@ -22,6 +23,7 @@ App::App() {
   if (!initImGui()) throw std::runtime_error("ImGui init failed");
 
   Logger::init();
+  runtime_.setAudioSink(&AudioEngine::instance());
   Logger::info("App", "Initialized");
 }
 
@@ -106,6 +108,11 @@ void App::handleEvent(const SDL_Event& e) {
   if (e.type == SDL_KEYDOWN && !e.key.repeat) {
     project_.setKeyDown(e.key.keysym.scancode, true);
   }
+  // key hats fire on auto-repeat too (running scripts aren't restarted), but
+  // not while typing into a text field
+  if (e.type == SDL_KEYDOWN && !ImGui::GetIO().WantCaptureKeyboard) {
+    runtime_.keyPressed(project_, e.key.keysym.scancode);
+  }
   if (e.type == SDL_KEYUP) {
     project_.setKeyDown(e.key.keysym.scancode, false);
   }
@@ -137,50 +144,69 @@ void App::endFrame() {
 
 int App::run() {
   MainDockspace ui;
-  TextureCache texCache(renderer_);
+  CollisionMaskCache costumeMasks; // filled by texCache, read by "touching"
+  TextureCache texCache(renderer_, &costumeMasks);
   Renderer2D renderer2d(renderer_, &texCache);
-  Watchdog watchdog;
+  runtime_.setCollisionMasks(&costumeMasks);
 
   uint64_t prevCounter = SDL_GetPerformanceCounter();
   double freq = (double)SDL_GetPerformanceFrequency();
 
   project_.resetToDefault();
+  Trace::setThreadName("main");
 
   while (running_) {
-    SDL_Event e;
-    while (SDL_PollEvent(&e)) handleEvent(e);
-
-    uint64_t now = SDL_GetPerformanceCounter();
-    float deltaSeconds = (float)((now - prevCounter) / freq);
-    prevCounter = now;
-    if (deltaSeconds > 0.05f) deltaSeconds = 0.05f;
-
-    Time::tick();
-
-    // update runtime before drawing
-    runtime_.tick(project_, deltaSeconds);
-
-    // Clear BEFORE ImGui draws so stage (SDL) can draw under UI
-    SDL_SetRenderDrawColor(renderer_, 20, 20, 20, 255);
-    SDL_RenderClear(renderer_);
-
-    beginFrame();
-
-    ui.draw(project_, renderer2d, runtime_);
-
-    if (ui.wantsExit()) {
-      SDL_Event quit{};
-      quit.type = SDL_QUIT;
-      SDL_PushEvent(&quit);
+    {
+      Trace::Scope frame("frame");
+      {
+        Trace::Scope trace("events");
+        SDL_Event e;
+        while (SDL_PollEvent(&e)) handleEvent(e);
+      }
+
+      uint64_t now = SDL_GetPerformanceCounter();
+      double deltaSeconds = (now - prevCounter) / freq;
+      prevCounter = now;
+
+      Time::tick();
+
+      // update runtime before drawing: fixed-rate ticks, the stage drawn
+      // between the last two
+      {
+        Trace::Scope trace("runtime tick");
+        runtime_.advance(project_, deltaSeconds);
+      }
+      renderer2d.setInterpolation(runtime_.poses(), runtime_.fixedStep().alpha());
+
+      {
+        Trace::Scope trace("ui draw");
+
+        // Clear BEFORE ImGui draws so stage (SDL) can draw under UI
+        SDL_SetRenderDrawColor(renderer_, 20, 20, 20, 255);
+        SDL_RenderClear(renderer_);
+
+        beginFrame();
+
+        ui.draw(project_, renderer2d, runtime_);
+
+        if (ui.wantsExit()) {
+          SDL_Event quit{};
+          quit.type = SDL_QUIT;
+          SDL_PushEvent(&quit);
+        }
+
+        endFrame();
+      }
+
+      Trace::Scope trace("present");
+      ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), renderer_);
+      SDL_RenderPresent(renderer_);
     }
-
-    watchdog.onFrameEnd();
-
-    endFrame();
-
-    ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), renderer_);
-    SDL_RenderPresent(renderer_);
+    Trace::frameEnd();
   }
+  Trace::finishCapture();
+  runtime_.finishInputRecording();
 
+  runtime_.setCollisionMasks(nullptr);
   return 0;
 }
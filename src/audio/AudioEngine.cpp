@@ -5,13 +5,14 @@
 #include <cstring>
 
 #include "core/Logger.h"
+#include "core/Trace.h"
 
 AudioEngine& AudioEngine::instance() {
   static AudioEngine g;
   return g;
 }
 
-bool AudioEngine::init() {
+bool AudioEngine::init(bool openDevice) {
   if (initialized_) return true;
 
   SDL_zero(wantSpec_);
@@ -22,6 +23,13 @@ bool AudioEngine::init() {
   wantSpec_.callback = &AudioEngine::audioCallback;
   wantSpec_.userdata = this;
 
+  if (!openDevice) {
+    haveSpec_ = wantSpec_;
+    initialized_ = true;
+    Logger::info("Audio", "AudioEngine initialized (no device)");
+    return true;
+  }
+
   dev_ = SDL_OpenAudioDevice(nullptr, 0, &wantSpec_, &haveSpec_, 0);
   if (!dev_) {
     Logger::warn("Audio", std::string("SDL_OpenAudioDevice failed: ") + SDL_GetError());
@@ -145,6 +153,12 @@ AudioEngine::PlayResult AudioEngine::playWav(const std::string& filePath, float
 }
 
 void AudioEngine::audioCallback(void* userdata, Uint8* stream, int len) {
+  thread_local bool named = false;
+  if (!named) {
+    Trace::setThreadName("audio");
+    named = true;
+  }
+  Trace::Scope trace("audio callback");
   ((AudioEngine*)userdata)->mix(stream, len);
 }
 
@@ -8,29 +8,30 @@
 #include <unordered_map>
 #include <vector>
 
+#include "audio/AudioSink.h"
+
 // Minimal audio engine:
 // - WAV only (via SDL_LoadWAV)
 // - Mixes multiple playing sounds
 // - Supports per-play volume and a simple pitch control via resampling
-class AudioEngine {
+class AudioEngine : public AudioSink {
 public:
-  struct PlayResult {
-    int handle{-1};
-    float durationSec{0.0f};
-  };
-
   static AudioEngine& instance();
 
-  bool init();
+  // openDevice=false: no SDL device; callers pull samples with mix()
+  // (benchmarks, offline rendering)
+  bool init(bool openDevice = true);
   void shutdown();
 
-  // volume: 0..1
-  // pitchSemitones: e.g. +12 = one octave up
-  PlayResult playWav(const std::string& filePath, float volume, float pitchSemitones);
-  void stopAll();
+  PlayResult playWav(const std::string& filePath, float volume, float pitchSemitones) override;
+  void stopAll() override;
 
   SDL_AudioSpec deviceSpec() const { return haveSpec_; }
 
+  // fills `len` bytes of device-format audio; normally driven by the SDL
+  // audio callback
+  void mix(Uint8* stream, int len);
+
 private:
   AudioEngine() = default;
   AudioEngine(const AudioEngine&) = delete;
@@ -51,7 +52,6 @@ private:
   };
 
   static void audioCallback(void* userdata, Uint8* stream, int len);
-  void mix(Uint8* stream, int len);
 
   const SoundData* loadCachedWavLocked(const std::string& filePath);
 
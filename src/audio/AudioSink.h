@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+
+// What the runtime needs from audio. AudioEngine is the SDL-backed sink used
+// by the editor; headless tools run with NullAudioSink.
+class AudioSink {
+public:
+  struct PlayResult {
+    int handle{-1};
+    float durationSec{0.0f};
+  };
+
+  virtual ~AudioSink() = default;
+
+  // volume: 0..1
+  // pitchSemitones: e.g. +12 = one octave up
+  virtual PlayResult playWav(const std::string& filePath, float volume, float pitchSemitones) = 0;
+  virtual void stopAll() = 0;
+};
+
+// Discards everything; sounds report zero duration, so "play until done"
+// doesn't wait.
+class NullAudioSink : public AudioSink {
+public:
+  PlayResult playWav(const std::string&, float, float) override { return {}; }
+  void stopAll() override {}
+};
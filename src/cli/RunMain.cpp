@@ -0,0 +1,199 @@
+// scratchy-run: load a project and run it headless (no window, no audio).
+//
+//   scratchy-run project.json [--ticks N] [--dt SECONDS] [--turbo]
+//                             [--parallel [--threads N]] [--answer TEXT] [--log]
+//                             [--trace FILE] [--seed N]
+//                             [--record FILE | --replay FILE]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "core/Logger.h"
+#include "core/Project.h"
+#include "core/Serialization.h"
+#include "core/Trace.h"
+#include "runtime/InputLog.h"
+#include "runtime/Runtime.h"
+
+namespace {
+
+struct Options {
+  std::string path;
+  int ticks{600};
+  float dt{1.0f / 60.0f};
+  bool turbo{false};
+  bool parallel{false};
+  int threads{0};       // parallel workers besides the main thread; 0: auto
+  std::string answer;  // auto-answer for "ask and wait"
+  bool printLog{false};
+  std::string tracePath; // Chrome trace of every tick
+  uint64_t seed{0};      // 0: the project's
+  std::string recordPath; // input log of the run (headless: just the answers)
+  std::string replayPath; // input log to feed the run
+  bool ticksGiven{false};
+  bool dtGiven{false};
+};
+
+void usage() {
+  std::fprintf(stderr,
+    "usage: scratchy-run <project.json> [--ticks N] [--dt SECONDS] [--turbo]\n"
+    "                    [--parallel [--threads N]] [--answer TEXT] [--log]\n"
+    "                    [--trace FILE] [--seed N] [--record FILE | --replay FILE]\n"
+    "  --ticks N      number of runtime ticks to run (default 600)\n"
+    "  --dt SECONDS   fixed time step per tick (default 1/60)\n"
+    "  --turbo        run in turbo mode\n"
+    "  --parallel     run sprites' scripts on worker threads\n"
+    "  --threads N    worker threads for --parallel (default: one per spare core)\n"
+    "  --answer TEXT  answer given to every \"ask and wait\" (default empty)\n"
+    "  --log          print the runtime log at exit\n"
+    "  --trace FILE   write a Chrome trace (chrome://tracing) of the ticks to FILE\n"
+    "  --seed N       seed for random blocks (default: the project's, else a new one)\n"
+    "  --record FILE  write the run's input log to FILE\n"
+    "  --replay FILE  replay an input log recorded in the editor: its seed, tick\n"
+    "                 length and input; --ticks defaults to its length\n");
+}
+
+bool parseArgs(int argc, char** argv, Options* o) {
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(a, "--ticks") == 0 && hasValue) {
+      o->ticks = std::atoi(argv[++i]);
+      o->ticksGiven = true;
+    } else if (std::strcmp(a, "--dt") == 0 && hasValue) {
+      o->dt = (float)std::atof(argv[++i]);
+      o->dtGiven = true;
+    } else if (std::strcmp(a, "--answer") == 0 && hasValue) {
+      o->answer = argv[++i];
+    } else if (std::strcmp(a, "--trace") == 0 && hasValue) {
+      o->tracePath = argv[++i];
+    } else if (std::strcmp(a, "--record") == 0 && hasValue) {
+      o->recordPath = argv[++i];
+    } else if (std::strcmp(a, "--replay") == 0 && hasValue) {
+      o->replayPath = argv[++i];
+    } else if (std::strcmp(a, "--seed") == 0 && hasValue) {
+      o->seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (std::strcmp(a, "--threads") == 0 && hasValue) {
+      o->threads = std::atoi(argv[++i]);
+    } else if (std::strcmp(a, "--turbo") == 0) {
+      o->turbo = true;
+    } else if (std::strcmp(a, "--parallel") == 0) {
+      o->parallel = true;
+    } else if (std::strcmp(a, "--log") == 0) {
+      o->printLog = true;
+    } else if (a[0] == '-' || !o->path.empty()) {
+      return false;
+    } else {
+      o->path = a;
+    }
+  }
+  return !o->path.empty() && o->ticks >= 0 && o->dt > 0.0f && o->threads >= 0 &&
+         (o->recordPath.empty() || o->replayPath.empty());
+}
+
+const char* levelName(LogLevel l) {
+  switch (l) {
+    case LogLevel::Info:  return "info";
+    case LogLevel::Warn:  return "warn";
+    case LogLevel::Error: return "error";
+  }
+  return "?";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, &opt)) {
+    usage();
+    return 1;
+  }
+
+  Logger::init();
+
+  Project project;
+  std::string err;
+  if (!Serialization::loadFromFile(project, opt.path, &err)) {
+    std::fprintf(stderr, "scratchy-run: failed to load '%s': %s\n", opt.path.c_str(), err.c_str());
+    return 1;
+  }
+
+  Runtime runtime; // no sink set: sounds go to the null sink
+  runtime.setTurbo(opt.turbo);
+  if (opt.parallel) runtime.setParallel(true, (unsigned)opt.threads);
+  runtime.setRandomSeed(opt.seed);
+  if (!opt.recordPath.empty()) runtime.recordInput(opt.recordPath);
+  if (!opt.replayPath.empty()) {
+    InputLog log;
+    if (!log.load(opt.replayPath, &err)) {
+      std::fprintf(stderr, "scratchy-run: failed to load '%s': %s\n", opt.replayPath.c_str(), err.c_str());
+      return 1;
+    }
+    if (!opt.ticksGiven) opt.ticks = (int)log.ticks;
+    if (opt.dtGiven && opt.dt != log.dt) std::fprintf(stderr, "scratchy-run: --dt ignored, the replay's is %.4f s\n", log.dt);
+    opt.dt = log.dt; // the replay ticks at its recorded length
+    runtime.replayInput(std::move(log));
+  }
+
+  using Clock = std::chrono::steady_clock;
+  const auto t0 = Clock::now();
+
+  Trace::setThreadName("main");
+  if (!opt.tracePath.empty()) Trace::capture(opt.ticks, opt.tracePath);
+
+  runtime.startGreenFlag(project);
+
+  int ticksRun = 0;
+  while (ticksRun < opt.ticks && runtime.isRunning() && !runtime.isPaused()) {
+    if (project.askActive() && !runtime.replayingInput()) {
+      project.setAskDraft(opt.answer);
+      project.submitAskAnswer();
+    }
+    {
+      Trace::Scope trace("runtime tick");
+      runtime.tick(project, opt.dt);
+    }
+    Trace::frameEnd();
+    ++ticksRun;
+  }
+  Trace::finishCapture(); // ended early
+  runtime.finishInputRecording();
+
+  const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+  std::printf("project: %s\n", opt.path.c_str());
+  std::printf("ticks:   %d of %d (dt %.4f s, %.2f s simulated)%s\n",
+              ticksRun, opt.ticks, opt.dt, ticksRun * opt.dt, opt.turbo ? " turbo" : "");
+  std::printf("state:   %s\n",
+              runtime.isRunning() ? (runtime.isPaused() ? "paused" : "running") : "finished");
+  std::printf("steps:   %llu\n", (unsigned long long)runtime.totalSteps());
+  std::printf("seed:    %llu\n", (unsigned long long)runtime.randomSeed());
+  std::printf("time:    %.3f ms total, %.3f us/tick\n",
+              ms, ticksRun > 0 ? ms * 1000.0 / ticksRun : 0.0);
+
+  std::printf("sprites: %d\n", (int)project.sprites().size());
+  for (const auto& sp : project.sprites()) {
+    std::printf("  [%d] %-16s x=%.2f y=%.2f dir=%.2f size=%.1f%% costume=%d %s",
+                sp.id, sp.name.c_str(), sp.x, sp.y, sp.directionDeg, sp.sizePercent,
+                sp.currentCostume, sp.visible ? "shown" : "hidden");
+    if (!sp.sayText.empty()) std::printf(" say=\"%s\"", sp.sayText.c_str());
+    std::printf("\n");
+  }
+  if (!project.clones().empty()) std::printf("clones:  %d\n", (int)project.clones().size());
+
+  if (opt.printLog) {
+    for (const auto& e : Logger::entries()) {
+      std::printf("[%s] %s: %s\n", levelName(e.level), e.tag.c_str(), e.msg.c_str());
+    }
+  }
+
+  if (!runtime.lastError().empty()) {
+    std::fprintf(stderr, "error: %s\n", runtime.lastError().c_str());
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <SDL.h>
+
+// Keyboard and mouse as scripts see them for one tick. Project collects the
+// live input between ticks and Runtime snapshots it once per tick, so every
+// script of a tick, on any thread, reads the same state, and a key tapped
+// and let go between two ticks still counts as down for one.
+struct InputSnapshot {
+  static constexpr size_t kKeys = SDL_NUM_SCANCODES;
+  static constexpr uint16_t kMouseButton = (uint16_t)kKeys; // Edge::key of the mouse button
+  using KeyBits = std::array<uint64_t, (kKeys + 63) / 64>;
+
+  struct Edge {
+    uint16_t key{0}; // scancode, or kMouseButton
+    bool down{false};
+  };
+
+  KeyBits held{};     // down when the snapshot was taken
+  KeyBits pressed{};  // went down since the last snapshot
+  KeyBits released{}; // went up since the last snapshot
+  std::vector<Edge> edges; // every change since the last snapshot, in order
+
+  float mouseX{0.0f}, mouseY{0.0f};
+  bool mouseValid{false}; // pointer over the stage
+  bool mouseHeld{false};
+  bool mousePressed{false};
+  bool mouseReleased{false};
+
+  static bool test(const KeyBits& bits, size_t k) { return k < kKeys && (bits[k >> 6] >> (k & 63)) & 1u; }
+  static void set(KeyBits& bits, size_t k, bool on) {
+    if (k >= kKeys) return;
+    if (on) bits[k >> 6] |= uint64_t(1) << (k & 63);
+    else bits[k >> 6] &= ~(uint64_t(1) << (k & 63));
+  }
+
+  // held, or tapped since the last tick
+  bool keyDown(SDL_Scancode sc) const { return test(held, (size_t)sc) || test(pressed, (size_t)sc); }
+  bool keyPressed(SDL_Scancode sc) const { return test(pressed, (size_t)sc); }
+  bool keyReleased(SDL_Scancode sc) const { return test(released, (size_t)sc); }
+  bool mouseDown() const { return mouseHeld || mousePressed; }
+};
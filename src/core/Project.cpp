@@ -2,14 +2,115 @@
 #include "core/Logger.h"
 #include <unordered_set>
 #include <algorithm>
+#include <cctype>
+#include <utility>
 
-Sprite* Project::findSpriteById(int id) {
-  for (auto& s : sprites_) if (s.id == id) return &s;
+static std::string lowerName(const std::string& s) {
+  std::string out = s;
+  for (char& c : out) c = (char)std::tolower((unsigned char)c);
+  return out;
+}
+
+static bool equalsLower(const std::string& name, const std::string& lowered) {
+  if (name.size() != lowered.size()) return false;
+  for (size_t i = 0; i < name.size(); ++i) {
+    if ((char)std::tolower((unsigned char)name[i]) != lowered[i]) return false;
+  }
+  return true;
+}
+
+void Project::rebuildSpriteIndex() const {
+  spriteIndex_.clear();
+  spriteIndex_.reserve(sprites_.size());
+  for (size_t i = 0; i < sprites_.size(); ++i) spriteIndex_[sprites_[i].id] = i;
+}
+
+void Project::refreshSpriteIndex() const {
+  bool current = spriteIndex_.size() == sprites_.size();
+  for (size_t i = 0; current && i < sprites_.size(); ++i) {
+    auto it = spriteIndex_.find(sprites_[i].id);
+    current = it != spriteIndex_.end() && it->second == i;
+  }
+  if (!current) rebuildSpriteIndex();
+}
+
+const Sprite* Project::findSpriteById(int id) const {
+  auto it = spriteIndex_.find(id);
+  if (it != spriteIndex_.end() && it->second < sprites_.size() && sprites_[it->second].id == id) {
+    return &sprites_[it->second];
+  }
+
+  // stale entry, or sprites() was resized behind our back
+  if (it != spriteIndex_.end() || spriteIndex_.size() != sprites_.size()) {
+    rebuildSpriteIndex();
+    it = spriteIndex_.find(id);
+    if (it != spriteIndex_.end()) return &sprites_[it->second];
+  }
   return nullptr;
 }
 
+Sprite* Project::findSpriteById(int id) {
+  return const_cast<Sprite*>(std::as_const(*this).findSpriteById(id));
+}
+
+void Project::rebuildNameIndex() const {
+  nameIndex_.clear();
+  nameIndex_.reserve(sprites_.size());
+  for (const auto& sp : sprites_) nameIndex_.emplace(lowerName(sp.name), sp.id); // first one wins
+}
+
+const Sprite* Project::findSpriteByLowerName(const std::string& lowered) const {
+  auto it = nameIndex_.find(lowered);
+  if (it != nameIndex_.end()) {
+    const Sprite* sp = findSpriteById(it->second);
+    if (sp && equalsLower(sp->name, lowered)) return sp;
+  }
+
+  // unknown or renamed since the index was built
+  rebuildNameIndex();
+  it = nameIndex_.find(lowered);
+  return it != nameIndex_.end() ? findSpriteById(it->second) : nullptr;
+}
+
+Sprite& Project::addSprite(Sprite sp) {
+  sprites_.push_back(std::move(sp));
+  Sprite& added = sprites_.back();
+  spriteIndex_[added.id] = sprites_.size() - 1;
+  for (size_t i = 0; i < added.scripts.size(); ++i) scriptIndex_[added.scripts[i].id] = i;
+  ++scriptsRevision_;
+  markDirty();
+  return added;
+}
+
+void Project::clearSprites() {
+  sprites_.clear();
+  clones_.clear();
+  spriteIndex_.clear();
+  scriptIndex_.clear();
+  nameIndex_.clear();
+  ++scriptsRevision_;
+  markDirty();
+}
+
+bool Project::removeSprite(int id) {
+  const Sprite* sp = findSpriteById(id);
+  if (!sp) return false;
+
+  for (const auto& sc : sp->scripts) scriptIndex_.erase(sc.id);
+  clones_.releaseAll(id);
+  sprites_.erase(sprites_.begin() + (sp - sprites_.data()));
+  rebuildSpriteIndex(); // later sprites moved down one slot
+  ++scriptsRevision_;
+  markDirty();
+  return true;
+}
+
 void Project::newProject() {
+  const uint64_t scriptsRevision = scriptsRevision_;
+  const uint64_t linksRevision = linksRevision_;
   *this = Project{};
+  scriptsRevision_ = scriptsRevision + 1; // keep moving forward for observers
+  linksRevision_ = linksRevision + 1;
   resetToDefault();
   setFilePath("");
   clearDirty();
@@ -18,14 +119,22 @@ void Project::newProject() {
 void Project::resetToDefault() {
   stage_ = Stage{};
   sprites_.clear();
+  clones_.clear();
+  spriteIndex_.clear();
+  scriptIndex_.clear();
+  nameIndex_.clear();
+  ++scriptsRevision_;
   filePath_.clear();
   dirty_ = false;
+  randomSeed_ = 0;
   spriteIds_.reset(1);
   blockIds_.reset(1);
   scriptIds_.reset(1);
 
-  keysDown_.fill(false);
-  mouseDown_ = false;
+  keysHeld_ = {};
+  mouseHeld_ = false;
+  inputEdges_.clear();
+  input_ = InputSnapshot{};
   askActive_ = false;
   askAnswered_ = false;
   askPrompt_.clear();
@@ -43,6 +152,48 @@ void Project::resetToDefault() {
   s.visible = true;
   s.sizePercent = 100; // پیش‌فرض :contentReference[oaicite:5]{index=5}
   sprites_.push_back(std::move(s));
+  spriteIndex_[sprites_.back().id] = 0;
+}
+
+void Project::setKeyDown(SDL_Scancode sc, bool down) {
+  if ((size_t)sc >= InputSnapshot::kKeys || InputSnapshot::test(keysHeld_, (size_t)sc) == down) return;
+  InputSnapshot::set(keysHeld_, (size_t)sc, down);
+  if (inputEdges_.size() < kMaxInputEdges) inputEdges_.push_back({(uint16_t)sc, down});
+}
+
+void Project::setMouseButtonDown(bool down) {
+  if (mouseHeld_ == down) return;
+  mouseHeld_ = down;
+  if (inputEdges_.size() < kMaxInputEdges) inputEdges_.push_back({InputSnapshot::kMouseButton, down});
+}
+
+void Project::snapshotInput() {
+  InputSnapshot& s = input_;
+  s.pressed = {};
+  s.released = {};
+  s.mousePressed = false;
+  s.mouseReleased = false;
+  for (const InputSnapshot::Edge& e : inputEdges_) {
+    if (e.key == InputSnapshot::kMouseButton) {
+      (e.down ? s.mousePressed : s.mouseReleased) = true;
+    } else {
+      InputSnapshot::set(e.down ? s.pressed : s.released, e.key, true);
+    }
+  }
+  s.edges.swap(inputEdges_); // the two edge buffers trade places; neither reallocates
+  inputEdges_.clear();
+
+  s.held = keysHeld_;
+  s.mouseHeld = mouseHeld_;
+  s.mouseX = mouseX_;
+  s.mouseY = mouseY_;
+  s.mouseValid = mouseValid_;
+}
+
+void Project::resetInput(const InputSnapshot::KeyBits& held, bool mouseDown) {
+  keysHeld_ = held;
+  mouseHeld_ = mouseDown;
+  inputEdges_.clear();
 }
 
 void Project::beginAsk(std::string prompt) {
@@ -56,6 +207,7 @@ void Project::submitAskAnswer() {
   answer_ = askDraft_;
   askActive_ = false;
   askAnswered_ = true;
+  ++answerRevision_;
 }
 
 bool Project::consumeAskAnswered() {
@@ -65,15 +217,24 @@ bool Project::consumeAskAnswered() {
 }
 
 
+void Project::rebuildScriptIndex(const Sprite& sp) const {
+  for (size_t i = 0; i < sp.scripts.size(); ++i) scriptIndex_[sp.scripts[i].id] = i;
+}
+
 Script* Project::findScript(Sprite& sp, int scriptId) {
-  for (auto& sc : sp.scripts) if (sc.id == scriptId) return &sc;
+  auto valid = [&](size_t i) { return i < sp.scripts.size() && sp.scripts[i].id == scriptId; };
+
+  auto it = scriptIndex_.find(scriptId);
+  if (it != scriptIndex_.end() && valid(it->second)) return &sp.scripts[it->second];
+
+  rebuildScriptIndex(sp);
+  it = scriptIndex_.find(scriptId);
+  if (it != scriptIndex_.end() && valid(it->second)) return &sp.scripts[it->second];
   return nullptr;
 }
 
 Block* Project::findBlock(Sprite& sp, int blockId) {
-  auto it = sp.blocks.find(blockId);
-  if (it == sp.blocks.end()) return nullptr;
-  return &it->second;
+  return sp.blocks.find(blockId);
 }
 
 int Project::createScript(Sprite& sp, float x, float y, BlockType hatType) {
@@ -86,11 +247,15 @@ int Project::createScript(Sprite& sp, float x, float y, BlockType hatType) {
   hat.x = x;
   hat.y = y;
   hat.nextId = -1;
+  if (hatType == BlockType::WhenKeyPressed) hat.args = {"space"};
+  if (hatType == BlockType::WhenIReceive) hat.args = {"message1"};
 
   sc.headBlockId = hat.id;
-  sp.blocks[hat.id] = hat;
+  sp.blocks.insert(hat);
   sp.scripts.push_back(sc);
+  scriptIndex_[sc.id] = sp.scripts.size() - 1;
   sp.selectedScriptId = sc.id;
+  ++scriptsRevision_;
 
   markDirty();
   Logger::info("Script", "Created script id=" + std::to_string(sc.id));
@@ -106,7 +271,8 @@ int Project::appendBlockToScript(Sprite& sp, int scriptId, BlockType type) {
   if (curId < 0) return -1;
 
   Block* cur = findBlock(sp, curId);
-  while (cur && cur->nextId != -1) {
+  size_t hops = 0;
+  while (cur && cur->nextId != -1 && hops++ < sp.blocks.size()) {
     cur = findBlock(sp, cur->nextId);
   }
 
@@ -144,6 +310,14 @@ int Project::appendBlockToScript(Sprite& sp, int scriptId, BlockType type) {
     case BlockType::StopThisScript: b.args = {}; break;
     case BlockType::StopAll:        b.args = {}; break;
 
+    // Events
+    case BlockType::Broadcast:        b.args = {"message1"}; break;
+    case BlockType::BroadcastAndWait: b.args = {"message1"}; break;
+
+    // Clones
+    case BlockType::CreateCloneOf:    b.args = {"myself"}; break;
+    case BlockType::DeleteThisClone:  b.args = {}; break;
+
     // Sensing
     case BlockType::AskAndWait:   b.args = {"What's your name?"}; break;
 
@@ -175,13 +349,21 @@ int Project::appendBlockToScript(Sprite& sp, int scriptId, BlockType type) {
     default: break;
   }
 
-  sp.blocks[b.id] = b;
+  b.prevId = cur ? cur->id : -1;
+  sp.blocks.insert(b);
   if (cur) cur->nextId = b.id;
+  ++linksRevision_;
 
   markDirty();
   return b.id;
 }
 
+void Project::setBlockArg(Block& b, size_t index, std::string value) {
+  b.setArg(index, std::move(value));
+  ++argsRevision_;
+  markDirty();
+}
+
 void Project::ensureNextIds(int nextSprite, int nextScript, int nextBlock) {
   spriteIds_.ensureAtLeast(nextSprite);
   scriptIds_.ensureAtLeast(nextScript);
@@ -189,31 +371,46 @@ void Project::ensureNextIds(int nextSprite, int nextScript, int nextBlock) {
 }
 
 
-int Project::findPrevInAnyChain(const Sprite& sp, int targetId) const {
-  // search through scripts for prev of target
-  for (const auto& sc : sp.scripts) {
-    int cur = sc.headBlockId;
-    int safety = 0;
-    while (cur != -1 && safety++ < 1000) {
-      auto it = sp.blocks.find(cur);
-      if (it == sp.blocks.end()) break;
-      int nx = it->second.nextId;
-      if (nx == targetId) return cur;
-      cur = nx;
+void Project::unlinkStack(Sprite& sp, int blockId) {
+  Block* b = sp.blocks.find(blockId);
+  if (!b) return;
+
+  if (Block* prev = sp.blocks.find(b->prevId)) {
+    if (prev->nextId == blockId) prev->nextId = -1;
+  } else if (Block* parent = sp.blocks.find(b->parentId)) {
+    if (parent->childHeadId == blockId) parent->childHeadId = -1;
+  } else {
+    for (auto& sc : sp.scripts) {
+      if (sc.headBlockId == blockId) sc.headBlockId = -1; // simple detach; empty scripts are kept
     }
+    ++scriptsRevision_;
   }
-  return -1;
+
+  b->prevId = -1;
+  b->parentId = -1;
+  ++linksRevision_;
+  markDirty();
 }
 
 bool Project::linkAfter(Sprite& sp, int afterBlockId, int newNextId) {
-  auto it = sp.blocks.find(afterBlockId);
-  if (it == sp.blocks.end()) return false;
-  it->second.nextId = newNextId;
+  Block* after = sp.blocks.find(afterBlockId);
+  if (!after || newNextId == afterBlockId) return false;
+  if (after->nextId == newNextId) return true;
+
+  // the old continuation is left detached
+  if (Block* old = sp.blocks.find(after->nextId)) old->prevId = -1;
+
+  Block* next = sp.blocks.find(newNextId);
+  if (next) unlinkStack(sp, newNextId);
+
+  after->nextId = next ? newNextId : -1;
+  if (next) next->prevId = afterBlockId;
+  ++linksRevision_;
   markDirty();
   return true;
 }
 
-int Project::appendToChain(Sprite& sp, int& headId, BlockType type, float x, float y) {
+int Project::appendToChain(Sprite& sp, int& headId, BlockType type, float x, float y, int parentId) {
   // create new block with defaults
   Block b;
   b.id = allocBlockId();
@@ -238,6 +435,14 @@ int Project::appendToChain(Sprite& sp, int& headId, BlockType type, float x, flo
     case BlockType::StopThisScript: b.args = {}; break;
     case BlockType::StopAll:        b.args = {}; break;
 
+    // Events
+    case BlockType::Broadcast:        b.args = {"message1"}; break;
+    case BlockType::BroadcastAndWait: b.args = {"message1"}; break;
+
+    // Clones
+    case BlockType::CreateCloneOf:    b.args = {"myself"}; break;
+    case BlockType::DeleteThisClone:  b.args = {}; break;
+
     // Sensing
     case BlockType::AskAndWait:   b.args = {"What's your name?"}; break;
 
@@ -252,41 +457,46 @@ int Project::appendToChain(Sprite& sp, int& headId, BlockType type, float x, flo
     default: break;
   }
 
-  sp.blocks[b.id] = b;
+  Block& nb = sp.blocks.insert(b);
+  ++linksRevision_;
 
   if (headId == -1) {
-    headId = b.id;
+    headId = nb.id;
+    nb.parentId = parentId;
     markDirty();
-    return b.id;
+    return nb.id;
   }
 
-  // find tail
+  // find tail (bounded by the block count in case a broken file has a cycle)
   int cur = headId;
-  int safety = 0;
-  while (cur != -1 && safety++ < 2000) {
-    auto it = sp.blocks.find(cur);
-    if (it == sp.blocks.end()) break;
-    if (it->second.nextId == -1) {
-      it->second.nextId = b.id;
+  size_t hops = 0;
+  while (cur != -1 && hops++ < sp.blocks.size()) {
+    Block* tail = sp.blocks.find(cur);
+    if (!tail) break;
+    if (tail->nextId == -1) {
+      tail->nextId = nb.id;
+      nb.prevId = tail->id;
       break;
     }
-    cur = it->second.nextId;
+    cur = tail->nextId;
   }
 
   markDirty();
-  return b.id;
+  return nb.id;
 }
 
 
 void Project::deleteChainRecursive(Sprite& sp, int headId) {
+  // bounded by the block count before any erase, in case of a cycle
   int cur = headId;
-  int safety = 0;
-  while (cur != -1 && safety++ < 5000) {
-    auto it = sp.blocks.find(cur);
-    if (it == sp.blocks.end()) break;
+  const size_t limit = sp.blocks.size();
+  size_t hops = 0;
+  while (cur != -1 && hops++ < limit) {
+    const Block* b = sp.blocks.find(cur);
+    if (!b) break;
 
-    int next = it->second.nextId;
-    int child = it->second.childHeadId;
+    int next = b->nextId;
+    int child = b->childHeadId;
 
     // delete child first
     if (child != -1) {
@@ -296,6 +506,7 @@ void Project::deleteChainRecursive(Sprite& sp, int headId) {
     sp.blocks.erase(cur);
     cur = next;
   }
+  ++linksRevision_;
 }
 
 
@@ -306,6 +517,9 @@ bool Project::deleteScript(Sprite& sp, int scriptId) {
 
   deleteChainRecursive(sp, itSc->headBlockId);
   sp.scripts.erase(itSc);
+  scriptIndex_.erase(scriptId);
+  rebuildScriptIndex(sp); // later scripts moved down one slot
+  ++scriptsRevision_;
 
   if (sp.selectedScriptId == scriptId) {
     sp.selectedScriptId = sp.scripts.empty() ? 0 : sp.scripts.front().id;
@@ -317,38 +531,33 @@ bool Project::deleteScript(Sprite& sp, int scriptId) {
 
 
 bool Project::deleteBlock(Sprite& sp, int blockId) {
-  auto itDel = sp.blocks.find(blockId);
-  if (itDel == sp.blocks.end()) return false;
-
-  int next = itDel->second.nextId;
-
-  // head of a script?
-  for (auto& sc : sp.scripts) {
-    if (sc.headBlockId == blockId) {
-      if (itDel->second.childHeadId != -1) deleteChainRecursive(sp, itDel->second.childHeadId);
-      sp.blocks.erase(blockId);
-      sc.headBlockId = next;
-      markDirty();
-      return true;
+  const Block* del = sp.blocks.find(blockId);
+  if (!del) return false;
+
+  const int next = del->nextId;
+  const int prev = del->prevId;
+  const int parent = del->parentId;
+  const int child = del->childHeadId;
+
+  // whatever pointed at this block now points at its next
+  if (Block* p = sp.blocks.find(prev)) {
+    p->nextId = next;
+  } else if (Block* owner = sp.blocks.find(parent)) {
+    owner->childHeadId = next;
+  } else {
+    for (auto& sc : sp.scripts) {
+      if (sc.headBlockId == blockId) sc.headBlockId = next;
     }
+    ++scriptsRevision_;
   }
-
-  // prev in any script chain?
-  int prev = findPrevInAnyChain(sp, blockId);
-  if (prev != -1) {
-    auto itPrev = sp.blocks.find(prev);
-    if (itPrev != sp.blocks.end()) {
-      itPrev->second.nextId = next;
-    }
-    if (itDel->second.childHeadId != -1) deleteChainRecursive(sp, itDel->second.childHeadId);
-    sp.blocks.erase(blockId);
-    markDirty();
-    return true;
+  if (Block* n = sp.blocks.find(next)) {
+    n->prevId = prev;
+    n->parentId = parent;
   }
 
-  // detached
-  if (itDel->second.childHeadId != -1) deleteChainRecursive(sp, itDel->second.childHeadId);
+  if (child != -1) deleteChainRecursive(sp, child);
   sp.blocks.erase(blockId);
+  ++linksRevision_;
   markDirty();
   return true;
-}
\ No newline at end of file
+}
@@ -3,11 +3,14 @@
 #include <vector>
 
 #include <array>
+#include <unordered_map>
 #include <SDL.h>
 
 #include "model/Stage.h"
 #include "model/Sprite.h"
+#include "model/CloneStore.h"
 #include "core/IdGen.h"
+#include "core/InputSnapshot.h"
 #include "model/Block.h"
 #include "model/Script.h"
 
@@ -28,7 +31,23 @@ public:
   std::vector<Sprite>& sprites() { return sprites_; }
   const std::vector<Sprite>& sprites() const { return sprites_; }
 
+  // O(1) through an id -> index table. Add/remove sprites through these so
+  // the table stays current; direct edits to sprites() are picked up lazily.
   Sprite* findSpriteById(int id);
+  const Sprite* findSpriteById(int id) const;
+  // brings the id index up to date now, so findSpriteById() only reads until
+  // sprites change (parallel runners look sprites up from several threads)
+  void refreshSpriteIndex() const;
+  // first sprite whose name matches case-insensitively; takes the name
+  // already lowercased (compiled conditions keep it that way)
+  const Sprite* findSpriteByLowerName(const std::string& lowered) const;
+  Sprite& addSprite(Sprite sp);
+  bool removeSprite(int id);
+  void clearSprites();
+
+  // live clones of the sprites above (transient; not serialized)
+  CloneStore& clones() { return clones_; }
+  const CloneStore& clones() const { return clones_; }
 
   // --- IDs ---
   int allocSpriteId() { return spriteIds_.next(); }
@@ -39,40 +58,52 @@ public:
   void ensureNextIds(int nextSprite, int nextScript, int nextBlock);
 
   // --- blocks/scripts ---
-  Script* findScript(Sprite& sp, int scriptId);
+  Script* findScript(Sprite& sp, int scriptId);     // O(1), see scriptIndex_
   Block*  findBlock(Sprite& sp, int blockId);
 
   int createScript(Sprite& sp, float x, float y, BlockType hatType);
   int appendBlockToScript(Sprite& sp, int scriptId, BlockType type);
 
-  // deletion / linking helpers
+  // deletion / linking helpers (all O(1) in chain length via prevId/parentId)
   bool deleteBlock(Sprite& sp, int blockId);       // delete single block and re-link stack
   bool deleteScript(Sprite& sp, int scriptId);     // delete script and its block chain
   bool linkAfter(Sprite& sp, int afterBlockId, int newNextId); // set after->next = newNext (safe)
-  int  findPrevInAnyChain(const Sprite& sp, int targetId) const;
+  void unlinkStack(Sprite& sp, int blockId);       // detach block + everything below it
 
-  // chain helpers
-  int appendToChain(Sprite& sp, int& headId, BlockType type, float x, float y);
+  // chain helpers; parentId = owning control block when headId is its childHeadId
+  int appendToChain(Sprite& sp, int& headId, BlockType type, float x, float y, int parentId = -1);
 
   // delete helpers (recursive)
   void deleteChainRecursive(Sprite& sp, int headId);
 
-    // --- mouse on stage (transient; not serialized) ---
+  // edit an arg; bumps argsRevision() so the runtime can refresh compiled operands
+  void setBlockArg(Block& b, size_t index, std::string value);
+  uint64_t argsRevision() const { return argsRevision_; }
+
+  // bumped whenever a script is added/removed or gets a different head block
+  // (sprites added/removed included); the runtime's hat index keys off it
+  uint64_t scriptsRevision() const { return scriptsRevision_; }
+
+  // bumped by every link change inside a script (a block added, deleted or
+  // moved); compiled programs are stale once it moves
+  uint64_t linksRevision() const { return linksRevision_; }
+
+  // seed for the scripts' random numbers; saved with the project.
+  // 0: a new seed every run
+  uint64_t randomSeed() const { return randomSeed_; }
+  void setRandomSeed(uint64_t seed) { randomSeed_ = seed; }
+
+  // --- input (transient; not serialized) ---
+  // Live state, changed by events between ticks; scripts read input(),
+  // Runtime's snapshot of it taken once per tick.
   void setMouseWorld(float x, float y, bool valid) { mouseX_ = x; mouseY_ = y; mouseValid_ = valid; }
-  bool mouseWorldValid() const { return mouseValid_; }
-  float mouseWorldX() const { return mouseX_; }
-  float mouseWorldY() const { return mouseY_; }
+  void setKeyDown(SDL_Scancode sc, bool down);
+  void setMouseButtonDown(bool down);
 
-  // --- input states (transient; not serialized) ---
-  void setKeyDown(SDL_Scancode sc, bool down) {
-    if ((int)sc >= 0 && (int)sc < (int)keysDown_.size()) keysDown_[(size_t)sc] = down;
-  }
-  bool keyDown(SDL_Scancode sc) const {
-    if ((int)sc >= 0 && (int)sc < (int)keysDown_.size()) return keysDown_[(size_t)sc];
-    return false;
-  }
-  void setMouseButtonDown(bool down) { mouseDown_ = down; }
-  bool mouseDown() const { return mouseDown_; }
+  const InputSnapshot& input() const { return input_; }
+  void snapshotInput();
+  // replays: drop the live input since the last snapshot, these held instead
+  void resetInput(const InputSnapshot::KeyBits& held, bool mouseDown);
 
   // --- ask/answer (transient; not serialized) ---
   bool askActive() const { return askActive_; }
@@ -83,6 +114,7 @@ public:
   void setAskDraft(std::string v) { askDraft_ = std::move(v); }
   void submitAskAnswer();
   bool consumeAskAnswered();
+  uint64_t answerRevision() const { return answerRevision_; } // bumped by every answer
 
   // --- runtime control (transient; not serialized) ---
   void requestStopAllScripts() { stopAllScriptsRequested_ = true; }
@@ -105,18 +137,41 @@ private:
   std::string filePath_;
   Stage stage_;
   std::vector<Sprite> sprites_;
+  CloneStore clones_;
+
+  // sprite id -> index in sprites_, script id -> index in its sprite's
+  // scripts. A stale hit (index points at a different id) or a size mismatch
+  // means the vectors were edited directly: rebuild and retry.
+  void rebuildSpriteIndex() const;
+  void rebuildScriptIndex(const Sprite& sp) const;
+  mutable std::unordered_map<int, size_t> spriteIndex_;
+  mutable std::unordered_map<int, size_t> scriptIndex_;
+
+  // lowercased sprite name -> sprite id, built on first use. Names are edited
+  // in place by the UI, so a hit is re-checked against the sprite and a miss
+  // rebuilds once.
+  void rebuildNameIndex() const;
+  mutable std::unordered_map<std::string, int> nameIndex_;
 
   IdGen spriteIds_;
   IdGen scriptIds_;
   IdGen blockIds_;
+  uint64_t argsRevision_{0};
+  uint64_t scriptsRevision_{0};
+  uint64_t linksRevision_{0};
+  uint64_t randomSeed_{0};
   float mouseX_{0}, mouseY_{0};
   bool mouseValid_{false};
 
-  std::array<bool, SDL_NUM_SCANCODES> keysDown_{};
-  bool mouseDown_{false};
+  static constexpr size_t kMaxInputEdges = 256; // between two snapshots; more are dropped
+  InputSnapshot::KeyBits keysHeld_{};
+  bool mouseHeld_{false};
+  std::vector<InputSnapshot::Edge> inputEdges_; // since the last snapshot
+  InputSnapshot input_;
 
   bool askActive_{false};
   bool askAnswered_{false};
+  uint64_t answerRevision_{0};
   std::string askPrompt_;
   std::string askDraft_;
   std::string answer_;
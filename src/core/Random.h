@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+
+// PCG32 (pcg-random.org): small, fast and seedable, with independent
+// streams. Each script runner owns one, so random blocks replay bit for bit
+// from the run's seed and parallel runners share no state.
+class Random {
+public:
+  Random() { seed(0, 0); }
+  Random(uint64_t seed, uint64_t stream) { this->seed(seed, stream); }
+
+  void seed(uint64_t seed, uint64_t stream) {
+    state_ = 0;
+    inc_ = (stream << 1) | 1u;
+    next();
+    state_ += mix(seed ^ mix(stream)); // nearby seeds and streams start far apart
+    next();
+  }
+
+  uint32_t next() {
+    const uint64_t old = state_;
+    state_ = old * 6364136223846793005ULL + inc_;
+    const uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    const uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31u));
+  }
+
+  double uniform() { return next() * (1.0 / 4294967296.0); } // [0, 1)
+  double range(double lo, double hi) { return lo + (hi - lo) * uniform(); }
+  // whole number in [lo, hi], like "pick random" with whole bounds
+  int64_t range(int64_t lo, int64_t hi) {
+    if (hi < lo) { const int64_t t = lo; lo = hi; hi = t; }
+    // unsigned all the way: hi - lo overflows int64 for wide ranges
+    const uint64_t span = (uint64_t)hi - (uint64_t)lo + 1; // 0: the whole int64 range
+    uint64_t bits = (uint64_t)next() << 32;
+    bits |= next();
+    return span ? (int64_t)((uint64_t)lo + bits % span) : (int64_t)bits;
+  }
+
+  // splitmix64 finalizer; also turns a clock reading into a seed
+  static uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+
+private:
+  uint64_t state_{0};
+  uint64_t inc_{1};
+};
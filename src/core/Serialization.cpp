@@ -2,6 +2,7 @@
 #include "Project.h"
 #include "core/Logger.h"
 #include "core/FileUtil.h"
+#include "core/Trace.h"
 
 #include <nlohmann/json.hpp>
 #include <algorithm>
@@ -96,6 +97,7 @@ static Block blockFromJson(const json& j) {
       b.args.push_back(a.get<std::string>());
     }
   }
+  b.argsChanged();
   return b;
 }
 
@@ -126,12 +128,9 @@ static json spriteToJson(const Sprite& sp) {
   json jScripts = json::array();
   for (const auto& sc : sp.scripts) jScripts.push_back(scriptToJson(sc));
 
-  // blocks (unordered_map -> array)
+  // blocks (BlockStore -> array)
   json jBlocks = json::array();
-  for (const auto& [id, b] : sp.blocks) {
-    (void)id;
-    jBlocks.push_back(blockToJson(b));
-  }
+  for (const Block& b : sp.blocks) jBlocks.push_back(blockToJson(b));
 
   return json{
     {"id", sp.id},
@@ -185,8 +184,9 @@ static Sprite spriteFromJson(const json& j) {
   if (j.contains("blocks") && j["blocks"].is_array()) {
     for (auto& it : j["blocks"]) {
       Block b = blockFromJson(it);
-      if (b.id != 0) sp.blocks[b.id] = std::move(b);
+      if (b.id != 0) sp.blocks.insert(std::move(b));
     }
+    sp.blocks.rebuildBackLinks();
   }
 
   // اگر selectedScriptId معتبر نبود، درستش کن
@@ -206,10 +206,12 @@ static Sprite spriteFromJson(const json& j) {
 namespace Serialization {
 
 bool saveToFile(const Project& project, const std::string& path, std::string* err) {
+  Trace::Scope trace("Serialization::saveToFile");
   try {
     json root;
     root["version"] = 3;
     root["stage"] = stageToJson(project.stage());
+    if (project.randomSeed()) root["randomSeed"] = project.randomSeed();
 
     json arr = json::array();
     for (const auto& sp : project.sprites()) arr.push_back(spriteToJson(sp));
@@ -231,6 +233,7 @@ bool saveToFile(const Project& project, const std::string& path, std::string* er
 }
 
 bool loadFromFile(Project& project, const std::string& path, std::string* err) {
+  Trace::Scope trace("Serialization::loadFromFile");
   try {
     std::string text;
     if (!FileUtil::readAllText(path, text)) {
@@ -248,7 +251,9 @@ bool loadFromFile(Project& project, const std::string& path, std::string* err) {
       project.stage() = stageFromJson(root["stage"]);
     }
 
-    project.sprites().clear();
+    project.setRandomSeed(root.value("randomSeed", (uint64_t)0));
+
+    project.clearSprites();
 
     int maxSpriteId = 0;
     int maxScriptId = 0;
@@ -260,9 +265,9 @@ bool loadFromFile(Project& project, const std::string& path, std::string* err) {
 
         maxSpriteId = std::max(maxSpriteId, sp.id);
         for (auto& sc : sp.scripts) maxScriptId = std::max(maxScriptId, sc.id);
-        for (auto& kv : sp.blocks)   maxBlockId  = std::max(maxBlockId, kv.first);
+        for (const Block& b : sp.blocks) maxBlockId = std::max(maxBlockId, b.id);
 
-        project.sprites().push_back(std::move(sp));
+        project.addSprite(std::move(sp));
       }
     }
 
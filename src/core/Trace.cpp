@@ -0,0 +1,157 @@
+#include "core/Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/FileUtil.h"
+#include "core/Logger.h"
+
+namespace Trace {
+
+namespace detail {
+std::atomic<bool> recording{false};
+
+uint64_t nowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace detail
+
+namespace {
+
+struct Event {
+  const char* name;
+  uint64_t startNs;
+  uint64_t endNs;
+};
+
+// One thread's spans. Only its thread writes; the lock is only ever
+// contended while a finished capture is being written out.
+struct Ring {
+  std::mutex mtx;
+  std::vector<Event> events; // kRingEvents once the thread first records
+  size_t next{0};
+  size_t count{0};
+  int tid{0};
+  std::string name;
+};
+
+std::mutex ringsMtx;
+std::vector<std::unique_ptr<Ring>> rings; // kept after their thread exits
+
+// capture state; main thread only
+int framesLeft_ = 0;
+std::string path_;
+uint64_t captureStart_ = 0;
+
+Ring& threadRing() {
+  thread_local Ring* ring = nullptr;
+  if (!ring) {
+    std::scoped_lock lk(ringsMtx);
+    rings.push_back(std::make_unique<Ring>());
+    ring = rings.back().get();
+    ring->tid = (int)rings.size();
+  }
+  return *ring;
+}
+
+void appendEscaped(std::string& out, const char* s) {
+  for (; *s; ++s) {
+    if (*s == '"' || *s == '\\') out += '\\';
+    out += *s;
+  }
+}
+
+void writeCapture() {
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  size_t written = 0;
+  char buf[96];
+
+  std::scoped_lock lk(ringsMtx);
+  for (auto& ring : rings) {
+    std::scoped_lock rl(ring->mtx);
+    if (!ring->name.empty()) {
+      std::snprintf(buf, sizeof(buf), "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",", ring->tid);
+      out += buf;
+      out += "\"args\":{\"name\":\"";
+      appendEscaped(out, ring->name.c_str());
+      out += "\"}},\n";
+    }
+
+    const size_t first = (ring->next + kRingEvents - ring->count) % kRingEvents;
+    for (size_t k = 0; k < ring->count; ++k) {
+      const Event& e = ring->events[(first + k) % kRingEvents];
+      const uint64_t start = std::max(e.startNs, captureStart_);
+      out += "{\"ph\":\"X\",\"pid\":1,\"name\":\"";
+      appendEscaped(out, e.name);
+      std::snprintf(buf, sizeof(buf), "\",\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f},\n", ring->tid,
+                    (start - captureStart_) / 1000.0, (e.endNs - start) / 1000.0);
+      out += buf;
+      ++written;
+    }
+  }
+  if (out.back() == '\n' && out[out.size() - 2] == ',') out.erase(out.size() - 2, 1);
+  out += "]}\n";
+
+  if (FileUtil::writeAllText(path_, out)) {
+    Logger::info("Trace", "Wrote " + std::to_string(written) + " span(s) to " + path_);
+  } else {
+    Logger::error("Trace", "Failed to write " + path_);
+  }
+}
+
+} // namespace
+
+void detail::record(const char* name, uint64_t startNs, uint64_t endNs) {
+  Ring& r = threadRing();
+  std::scoped_lock lk(r.mtx);
+  if (r.events.empty()) r.events.resize(kRingEvents);
+  r.events[r.next] = {name, startNs, endNs};
+  r.next = (r.next + 1) % kRingEvents;
+  r.count = std::min(r.count + 1, kRingEvents);
+}
+
+void setThreadName(const char* name) {
+  Ring& r = threadRing();
+  std::scoped_lock lk(r.mtx);
+  r.name = name;
+}
+
+void capture(int frames, std::string path) {
+  if (frames <= 0 || path.empty()) return;
+  {
+    std::scoped_lock lk(ringsMtx);
+    for (auto& ring : rings) {
+      std::scoped_lock rl(ring->mtx);
+      ring->next = 0;
+      ring->count = 0;
+    }
+  }
+  framesLeft_ = frames;
+  path_ = std::move(path);
+  captureStart_ = detail::nowNs();
+  detail::recording.store(true, std::memory_order_relaxed);
+  Logger::info("Trace", "Capturing " + std::to_string(frames) + " frame(s)");
+}
+
+bool capturing() { return framesLeft_ > 0; }
+int framesLeft() { return framesLeft_; }
+
+void frameEnd() {
+  if (framesLeft_ <= 0 || --framesLeft_ > 0) return;
+  detail::recording.store(false, std::memory_order_relaxed);
+  writeCapture();
+}
+
+void finishCapture() {
+  if (framesLeft_ <= 0) return;
+  framesLeft_ = 0;
+  detail::recording.store(false, std::memory_order_relaxed);
+  writeCapture();
+}
+
+} // namespace Trace
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Frame tracing in Chrome trace-event format (chrome://tracing, Perfetto).
+//
+//   { Trace::Scope s("ui.draw"); ... }
+//
+// marks a span of one thread's time. Spans are only recorded while a capture
+// runs (capture(N, path) for the next N frames; App calls frameEnd()), so
+// outside of one a Scope costs a relaxed atomic load. Each thread writes its
+// own ring buffer of the latest kRingEvents spans; the capture is written out
+// as JSON when its last frame ends.
+namespace Trace {
+
+constexpr size_t kRingEvents = 1 << 15; // per thread
+
+namespace detail {
+extern std::atomic<bool> recording;
+uint64_t nowNs();
+void record(const char* name, uint64_t startNs, uint64_t endNs);
+} // namespace detail
+
+inline bool recording() { return detail::recording.load(std::memory_order_relaxed); }
+
+// `name` must outlive the capture (a string literal)
+class Scope {
+public:
+  explicit Scope(const char* name) : name_(name), start_(recording() ? detail::nowNs() : 0) {}
+  ~Scope() {
+    if (start_) detail::record(name_, start_, detail::nowNs());
+  }
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  const char* name_;
+  uint64_t start_;
+};
+
+// shown as the thread's name in the viewer; call once from the thread
+void setThreadName(const char* name);
+
+// record the next `frames` frames, then write them to `path`
+void capture(int frames, std::string path);
+bool capturing();
+int framesLeft();
+
+// end of one frame: counts the capture down and writes it out when done
+void frameEnd();
+
+// write out a capture that is still running (the app or run is ending)
+void finishCapture();
+
+} // namespace Trace
@@ -1,21 +1,29 @@
 #include "Watchdog.h"
 #include "Logger.h"
 
+#include <utility>
+
 void Watchdog::beginFrame() {
   instrThisFrame_ = 0;
-  tripped_ = false;
 }
 
 void Watchdog::addInstructions(uint32_t count) {
   instrThisFrame_ += count;
-  if (instrThisFrame_ > limit_) tripped_ = true;
 }
 
-bool Watchdog::tripped() const { return tripped_; }
-
 void Watchdog::onFrameEnd() {
-  // فعلاً فقط اگر اتفاقی افتاد لاگ کن.
-  if (tripped_) {
-    Logger::error("Watchdog", "Infinite loop suspected. Execution should be stopped.");
-  }
-}
\ No newline at end of file
+  lastFrame_ = instrThisFrame_;
+}
+
+void Watchdog::trip(Report report) {
+  report_ = std::move(report);
+  tripped_ = true;
+  Logger::error("Watchdog", report_.message);
+}
+
+void Watchdog::clear() {
+  report_ = Report{};
+  tripped_ = false;
+}
+
+bool Watchdog::tripped() const { return tripped_; }
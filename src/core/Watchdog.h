@@ -1,15 +1,48 @@
 #pragma once
 #include <cstdint>
+#include <string>
 
+// Infinite-loop detection. Runtime times, per runner, how long it has been
+// running since it last yielded (a wait, the end of the script, a loop end
+// outside warp) — one clock read per slice, nothing per step — and asks the
+// watchdog whether that is over the limit. Time, not an instruction count:
+// a slow machine shouldn't trip sooner than a fast one lets a script finish.
+// The runner notes the loop at each back-edge, so a trip names the script
+// and block that were looping and the editor can offer to stop just that
+// script.
 class Watchdog {
 public:
+  struct Limits {
+    int unyieldedMillis = 5000; // one script running without yielding
+  };
+
+  struct Report {
+    int spriteId{0};
+    int scriptId{0};
+    int blockId{-1};         // the loop (or block) it was running
+    uint32_t instructions{0};
+    uint32_t millis{0};
+    std::string message;
+  };
+
   void beginFrame();
   void addInstructions(uint32_t count);
-  bool tripped() const;        // آیا بیش از حد مجاز شده؟
   void onFrameEnd();
+  uint32_t lastFrameInstructions() const { return lastFrame_; }
+
+  bool overLimit(int64_t unyieldedMillis) const { return unyieldedMillis >= limits_.unyieldedMillis; }
+  void trip(Report report);
+  void clear();
+  bool tripped() const;
+  const Report& report() const { return report_; }
+
+  Limits& limits() { return limits_; }
+  const Limits& limits() const { return limits_; }
 
 private:
   uint32_t instrThisFrame_{0};
-  uint32_t limit_{20000};      // بعداً قابل تنظیم از UI
+  uint32_t lastFrame_{0};
+  Limits limits_{};
+  Report report_{};
   bool tripped_{false};
-};
\ No newline at end of file
+};
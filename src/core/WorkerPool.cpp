@@ -0,0 +1,103 @@
+#include "core/WorkerPool.h"
+
+#include <string>
+
+#include "core/Trace.h"
+
+namespace {
+
+uint64_t pack(uint32_t begin, uint32_t end) { return (uint64_t)begin | ((uint64_t)end << 32); }
+
+} // namespace
+
+WorkerPool::WorkerPool(unsigned threads) : shares_(new Share[threads + 1]) {
+  threads_.reserve(threads);
+  for (unsigned i = 0; i < threads; ++i) threads_.emplace_back([this, i] { workerMain(i + 1); });
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::scoped_lock lk(mtx_);
+    quit_ = true;
+  }
+  wake_.notify_all();
+  for (auto& t : threads_) t.join();
+}
+
+unsigned WorkerPool::defaultThreads() {
+  const unsigned hw = std::thread::hardware_concurrency();
+  return hw > 1 ? hw - 1 : 0;
+}
+
+bool WorkerPool::take(Share& s, bool fromBack, uint32_t* out) {
+  uint64_t cur = s.range.load(std::memory_order_relaxed);
+  for (;;) {
+    const uint32_t begin = (uint32_t)cur;
+    const uint32_t end = (uint32_t)(cur >> 32);
+    if (begin >= end) return false;
+    const uint64_t next = fromBack ? pack(begin, end - 1) : pack(begin + 1, end);
+    if (s.range.compare_exchange_weak(cur, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+      *out = fromBack ? end - 1 : begin;
+      return true;
+    }
+  }
+}
+
+void WorkerPool::drain(unsigned self) {
+  const unsigned n = threads() + 1;
+  const auto& fn = *job_;
+  uint32_t i;
+  while (take(shares_[self], false, &i)) fn(i);
+  for (unsigned k = 1; k < n; ++k) {
+    Share& victim = shares_[(self + k) % n];
+    while (take(victim, true, &i)) fn(i);
+  }
+}
+
+void WorkerPool::workerMain(unsigned self) {
+  Trace::setThreadName(("worker " + std::to_string(self)).c_str());
+  uint64_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock lk(mtx_);
+      wake_.wait(lk, [&] { return quit_ || generation_ != seen; });
+      if (quit_) return;
+      seen = generation_;
+    }
+    {
+      Trace::Scope trace("WorkerPool job");
+      drain(self);
+    }
+    {
+      std::scoped_lock lk(mtx_);
+      if (--busy_ == 0) done_.notify_one();
+    }
+  }
+}
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+  if (count == 0) return;
+  if (threads_.empty() || count == 1) {
+    for (size_t i = 0; i < count; ++i) fn(i);
+    return;
+  }
+
+  const size_t n = threads() + 1;
+  for (size_t t = 0; t < n; ++t) {
+    shares_[t].range.store(pack((uint32_t)(count * t / n), (uint32_t)(count * (t + 1) / n)),
+                           std::memory_order_relaxed);
+  }
+  {
+    std::scoped_lock lk(mtx_);
+    job_ = &fn;
+    busy_ = threads();
+    ++generation_;
+  }
+  wake_.notify_all();
+
+  drain(0);
+
+  std::unique_lock lk(mtx_);
+  done_.wait(lk, [&] { return busy_ == 0; });
+  job_ = nullptr;
+}
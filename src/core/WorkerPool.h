@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork-join thread pool: parallelFor(n, fn) runs fn(0..n-1) on the workers
+// plus the calling thread and returns when all calls are done.
+//
+// Work stealing over index ranges: each thread starts with its own
+// contiguous share of the indices and takes from the front of it; a thread
+// that runs dry takes from the back of the others' shares, so a few heavy
+// tasks among many light ones still spread out.
+class WorkerPool {
+public:
+  // `threads`: workers besides the calling thread; 0 runs everything inline
+  explicit WorkerPool(unsigned threads);
+  ~WorkerPool();
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  unsigned threads() const { return (unsigned)threads_.size(); }
+
+  // one less than the hardware threads (the caller is the other one)
+  static unsigned defaultThreads();
+
+  // fn must not throw
+  void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+private:
+  // [begin, end) packed as begin | end << 32, so owner and thieves can both
+  // take with a single compare-exchange
+  struct alignas(64) Share {
+    std::atomic<uint64_t> range{0};
+  };
+
+  bool take(Share& s, bool fromBack, uint32_t* out);
+  void drain(unsigned self);
+  void workerMain(unsigned self);
+
+  std::vector<std::thread> threads_;
+  std::unique_ptr<Share[]> shares_; // [0] is the calling thread's
+  const std::function<void(size_t)>* job_{nullptr};
+
+  std::mutex mtx_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  uint64_t generation_{0}; // bumped per parallelFor
+  unsigned busy_{0};       // workers still draining the current job
+  bool quit_{false};
+};
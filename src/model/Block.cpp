@@ -1 +1,93 @@
-#include "Block.h"
\ No newline at end of file
+#include "model/Block.h"
+
+#include <cstdlib>
+
+void Block::parseArgs() const {
+  parsed_.resize(args.size());
+  for (size_t i = 0; i < args.size(); ++i) {
+    const std::string& s = args[i];
+    BlockArg& a = parsed_[i];
+    a = BlockArg{};
+    if (s.empty()) continue;
+
+    char* end = nullptr;
+    float v = std::strtof(s.c_str(), &end);
+    if (end == s.c_str()) continue;
+    a.num = v;
+    a.isNumber = true;
+  }
+  parsedValid_ = true;
+}
+
+const BlockArg* Block::arg(size_t i) const {
+  if (!parsedValid_ || parsed_.size() != args.size()) parseArgs();
+  return i < parsed_.size() ? &parsed_[i] : nullptr;
+}
+
+float Block::argNumber(size_t i, float def) const {
+  const BlockArg* a = arg(i);
+  return (a && a->isNumber) ? a->num : def;
+}
+
+void Block::setArg(size_t i, std::string value) {
+  if (args.size() <= i) args.resize(i + 1);
+  args[i] = std::move(value);
+  parsedValid_ = false;
+}
+
+const char* blockLabel(BlockType t) {
+  switch (t) {
+    case BlockType::WhenGreenFlag: return "when green flag clicked";
+    case BlockType::WhenKeyPressed: return "when key pressed";
+    case BlockType::WhenIReceive: return "when I receive";
+    case BlockType::Broadcast: return "broadcast";
+    case BlockType::BroadcastAndWait: return "broadcast and wait";
+    case BlockType::CreateCloneOf: return "create clone of";
+    case BlockType::WhenIStartAsClone: return "when I start as a clone";
+    case BlockType::DeleteThisClone: return "delete this clone";
+    case BlockType::MoveSteps: return "move steps";
+    case BlockType::TurnRight: return "turn right";
+    case BlockType::TurnLeft: return "turn left";
+    case BlockType::GoToXY: return "go to x y";
+    case BlockType::Say: return "say";
+    case BlockType::WaitSeconds: return "wait seconds";
+    case BlockType::WaitUntil: return "wait until";
+    case BlockType::Repeat: return "repeat";
+    case BlockType::RepeatUntil: return "repeat until";
+    case BlockType::Forever: return "forever";
+    case BlockType::IfThen: return "if then";
+    case BlockType::StopThisScript: return "stop this script";
+    case BlockType::StopAll: return "stop all";
+    case BlockType::AskAndWait: return "ask and wait";
+    case BlockType::SetX: return "set x to";
+    case BlockType::SetY: return "set y to";
+    case BlockType::ChangeXBy: return "change x by";
+    case BlockType::ChangeYBy: return "change y by";
+    case BlockType::GoToRandomPosition: return "go to random";
+    case BlockType::GoToMousePointer: return "go to mouse";
+    case BlockType::IfOnEdgeBounce: return "if on edge bounce";
+    case BlockType::StopAtEdge: return "stop at edge";
+    case BlockType::Think: return "think";
+    case BlockType::SwitchCostumeTo: return "switch costume to";
+    case BlockType::NextCostume: return "next costume";
+    case BlockType::SwitchBackdropTo: return "switch backdrop to";
+    case BlockType::NextBackdrop: return "next backdrop";
+    case BlockType::SetSizeTo: return "set size to";
+    case BlockType::ChangeSizeBy: return "change size by";
+    case BlockType::Show: return "show";
+    case BlockType::Hide: return "hide";
+    case BlockType::GoToFrontLayer: return "go to front layer";
+    case BlockType::GoBackLayers: return "go back layers";
+    case BlockType::LooksReporter: return "looks report";
+
+    // Sound
+    case BlockType::PlaySound: return "play sound";
+    case BlockType::PlaySoundUntilDone: return "play sound until done";
+    case BlockType::StopAllSounds: return "stop all sounds";
+    case BlockType::SetVolumeTo: return "set volume to";
+    case BlockType::ChangeVolumeBy: return "change volume by";
+    case BlockType::SetPitchTo: return "set pitch to";
+    case BlockType::ChangePitchBy: return "change pitch by";
+    default: return "block";
+  }
+}
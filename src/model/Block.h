@@ -1,7 +1,10 @@
 #pragma once
+#include <memory>
 #include <string>
 #include <vector>
 
+struct Condition; // runtime/Condition.h
+
 enum class BlockType : int {
   // Events
   WhenGreenFlag,
@@ -66,6 +69,32 @@ enum class BlockType : int {
 
   // Sensing (31-34)
   AskAndWait,   // 33) ask ( ) and wait
+
+  // Events: broadcasts (appended; BlockType is saved as an int)
+  WhenIReceive,
+  Broadcast,
+  BroadcastAndWait,
+
+  // Control: clones
+  CreateCloneOf,     // arg: "myself" or a sprite name
+  WhenIStartAsClone,
+  DeleteThisClone,
+};
+
+inline bool isHatBlock(BlockType t) {
+  return t == BlockType::WhenGreenFlag || t == BlockType::WhenKeyPressed || t == BlockType::WhenIReceive ||
+         t == BlockType::WhenIStartAsClone;
+}
+
+// short text for the editor and diagnostics ("move steps", "forever", ...)
+const char* blockLabel(BlockType t);
+
+// Parsed form of one Block::args entry, cached so the runtime does not have to
+// run strtof every time the block executes.
+struct BlockArg {
+  float num{0.0f};
+  bool isNumber{false};
+  mutable std::shared_ptr<const Condition> cond; // compiled by the runtime on first use
 };
 
 struct Block {
@@ -75,10 +104,28 @@ struct Block {
   // workspace UI position
   float x{0}, y{0};
 
-  // args as strings (so UI can edit)
+  // args as strings (so UI can edit).
+  // Edit through setArg(), or call argsChanged() after touching them directly.
   std::vector<std::string> args;
 
   // chain links
   int nextId{-1};
   int childHeadId{-1};
+
+  // back links, kept in sync by Project's editing helpers (not saved; the
+  // loader rebuilds them with BlockStore::rebuildBackLinks)
+  int prevId{-1};    // block whose nextId is this one
+  int parentId{-1};  // control block whose childHeadId is this one (body heads only)
+
+  // parsed args (rebuilt lazily after an edit)
+  const BlockArg* arg(size_t i) const;
+  float argNumber(size_t i, float def) const;
+  void setArg(size_t i, std::string value);
+  void argsChanged() { parsedValid_ = false; }
+
+private:
+  void parseArgs() const;
+
+  mutable std::vector<BlockArg> parsed_;
+  mutable bool parsedValid_{false};
 };
\ No newline at end of file
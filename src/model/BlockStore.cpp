@@ -0,0 +1,181 @@
+#include "model/BlockStore.h"
+
+#include <bit>
+#include <utility>
+
+BlockStore::BlockStore(const BlockStore& o) {
+  *this = o;
+}
+
+BlockStore& BlockStore::operator=(const BlockStore& o) {
+  if (this == &o) return *this;
+
+  pages_.clear();
+  for (uint32_t p = 0; p < (uint32_t)o.pages_.size(); ++p) {
+    const uint32_t n = pageSize(p);
+    pages_.push_back(std::make_unique<Slot[]>(n));
+    for (uint32_t i = 0; i < n; ++i) pages_[p][i] = o.pages_[p][i];
+  }
+  used_ = o.used_;
+  free_ = o.free_;
+  live_ = o.live_;
+  index_ = o.index_;
+  indexCount_ = o.indexCount_;
+  indexShift_ = o.indexShift_;
+  return *this;
+}
+
+Block* BlockStore::find(int id) {
+  uint32_t s = slotOf(id);
+  return s == kNoSlot ? nullptr : &slotAt(s).block;
+}
+
+const Block* BlockStore::find(int id) const {
+  uint32_t s = slotOf(id);
+  return s == kNoSlot ? nullptr : &slotAt(s).block;
+}
+
+Block& BlockStore::insert(Block b) {
+  uint32_t s = slotOf(b.id);
+  if (s != kNoSlot) {
+    Block& dst = slotAt(s).block;
+    dst = std::move(b);
+    return dst;
+  }
+
+  s = allocSlot();
+  Slot& slot = slotAt(s);
+  slot.block = std::move(b);
+  slot.live = true;
+  ++live_;
+  indexInsert(slot.block.id, s);
+  return slot.block;
+}
+
+bool BlockStore::erase(int id) {
+  uint32_t s = slotOf(id);
+  if (s == kNoSlot) return false;
+
+  Slot& slot = slotAt(s);
+  slot.block = Block{}; // drop the args now, not when the slot is reused
+  slot.live = false;
+  ++slot.gen;
+  --live_;
+  free_.push_back(s);
+  indexErase(id);
+  return true;
+}
+
+BlockHandle BlockStore::handle(int id) const {
+  uint32_t s = slotOf(id);
+  if (s == kNoSlot) return {};
+  return BlockHandle{s, slotAt(s).gen};
+}
+
+Block* BlockStore::get(BlockHandle h) {
+  if (h.slot >= used_) return nullptr;
+  Slot& slot = slotAt(h.slot);
+  return (slot.live && slot.gen == h.gen) ? &slot.block : nullptr;
+}
+
+const Block* BlockStore::get(BlockHandle h) const {
+  if (h.slot >= used_) return nullptr;
+  const Slot& slot = slotAt(h.slot);
+  return (slot.live && slot.gen == h.gen) ? &slot.block : nullptr;
+}
+
+void BlockStore::rebuildBackLinks() {
+  for (Block& b : *this) {
+    b.prevId = -1;
+    b.parentId = -1;
+  }
+  for (const Block& b : *this) {
+    if (Block* next = find(b.nextId)) next->prevId = b.id;
+    if (Block* child = find(b.childHeadId)) child->parentId = b.id;
+  }
+}
+
+void BlockStore::clear() {
+  pages_.clear();
+  used_ = 0;
+  free_.clear();
+  live_ = 0;
+  index_.clear();
+  indexCount_ = 0;
+  indexShift_ = 32;
+}
+
+uint32_t BlockStore::allocSlot() {
+  if (!free_.empty()) {
+    uint32_t s = free_.back();
+    free_.pop_back();
+    return s;
+  }
+
+  uint32_t s = used_++;
+  uint32_t p = pageOf(s);
+  if (p >= (uint32_t)pages_.size()) pages_.push_back(std::make_unique<Slot[]>(pageSize(p)));
+  return s;
+}
+
+// ---- id -> slot index ----
+
+size_t BlockStore::bucket(int id) const {
+  // Fibonacci hashing (top bits); ids are mostly sequential
+  return (size_t)(((uint32_t)id * 2654435769u) >> indexShift_);
+}
+
+uint32_t BlockStore::slotOf(int id) const {
+  if (index_.empty() || id == kEmptyId) return kNoSlot;
+  const size_t mask = index_.size() - 1;
+  for (size_t i = bucket(id);; i = (i + 1) & mask) {
+    const IndexEntry& e = index_[i];
+    if (e.id == id) return e.slot;
+    if (e.id == kEmptyId) return kNoSlot;
+  }
+}
+
+void BlockStore::indexInsert(int id, uint32_t slot) {
+  if ((indexCount_ + 1) * 4 > index_.size() * 3) {
+    indexRehash(index_.empty() ? 16 : index_.size() * 2);
+  }
+  const size_t mask = index_.size() - 1;
+  size_t i = bucket(id);
+  while (index_[i].id != kEmptyId) i = (i + 1) & mask;
+  index_[i] = IndexEntry{id, slot};
+  ++indexCount_;
+}
+
+void BlockStore::indexErase(int id) {
+  const size_t mask = index_.size() - 1;
+  size_t i = bucket(id);
+  while (index_[i].id != id) {
+    if (index_[i].id == kEmptyId) return;
+    i = (i + 1) & mask;
+  }
+
+  // shift later entries of the probe run back into the hole
+  for (size_t j = (i + 1) & mask; index_[j].id != kEmptyId; j = (j + 1) & mask) {
+    size_t home = bucket(index_[j].id);
+    bool movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+    if (movable) {
+      index_[i] = index_[j];
+      i = j;
+    }
+  }
+  index_[i] = IndexEntry{kEmptyId, kNoSlot};
+  --indexCount_;
+}
+
+void BlockStore::indexRehash(size_t capacity) {
+  std::vector<IndexEntry> old = std::move(index_);
+  index_.assign(capacity, IndexEntry{kEmptyId, kNoSlot});
+  indexShift_ = 32u - (uint32_t)std::countr_zero(capacity);
+  const size_t mask = capacity - 1;
+  for (const IndexEntry& e : old) {
+    if (e.id == kEmptyId) continue;
+    size_t i = bucket(e.id);
+    while (index_[i].id != kEmptyId) i = (i + 1) & mask;
+    index_[i] = e;
+  }
+}
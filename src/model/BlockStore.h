@@ -0,0 +1,122 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "model/Block.h"
+
+// Generational reference to a block slot. Stays cheap to validate after the
+// block is deleted: the slot's generation moves on and get() returns null.
+struct BlockHandle {
+  uint32_t slot{UINT32_MAX};
+  uint32_t gen{0};
+
+  bool valid() const { return slot != UINT32_MAX; }
+  bool operator==(const BlockHandle& o) const { return slot == o.slot && gen == o.gen; }
+};
+
+// Per-sprite block storage.
+//
+// Blocks live in pages of slots that double in size (16, 32, 64, ...), so
+// walking a script touches contiguous memory, small sprites stay small, and a
+// Block& stays valid until that block is erased (pages never move), like the
+// unordered_map this replaces.
+//
+// Freed slots go on a free list and are reused. Block ids (which are what
+// nextId/childHeadId and the save file use) map to slots through a flat
+// open-addressing table.
+class BlockStore {
+public:
+  BlockStore() = default;
+  BlockStore(const BlockStore& o);
+  BlockStore& operator=(const BlockStore& o);
+  BlockStore(BlockStore&&) noexcept = default;
+  BlockStore& operator=(BlockStore&&) noexcept = default;
+
+  // --- by id ---
+  Block* find(int id);
+  const Block* find(int id) const;
+  bool contains(int id) const { return slotOf(id) != kNoSlot; }
+
+  // insert (or overwrite the block with the same id); returns the stored block
+  Block& insert(Block b);
+  bool erase(int id);
+
+  // --- by handle ---
+  BlockHandle handle(int id) const;
+  Block* get(BlockHandle h);
+  const Block* get(BlockHandle h) const;
+
+  // recompute prevId/parentId from nextId/childHeadId (after loading)
+  void rebuildBackLinks();
+
+  size_t size() const { return live_; }
+  bool empty() const { return live_ == 0; }
+  void clear();
+
+  // iteration over live blocks in slot order
+  template <class StoreT, class BlockT>
+  class Iter {
+  public:
+    Iter(StoreT* s, uint32_t slot) : s_(s), slot_(slot) { skip(); }
+    BlockT& operator*() const { return s_->slotAt(slot_).block; }
+    BlockT* operator->() const { return &s_->slotAt(slot_).block; }
+    Iter& operator++() { ++slot_; skip(); return *this; }
+    bool operator!=(const Iter& o) const { return slot_ != o.slot_; }
+    bool operator==(const Iter& o) const { return slot_ == o.slot_; }
+
+  private:
+    void skip() { while (slot_ < s_->used_ && !s_->slotAt(slot_).live) ++slot_; }
+    StoreT* s_;
+    uint32_t slot_;
+  };
+  using iterator = Iter<BlockStore, Block>;
+  using const_iterator = Iter<const BlockStore, const Block>;
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, used_); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, used_); }
+
+private:
+  static constexpr uint32_t kFirstPageBits = 4; // page p holds 16 << p slots
+  static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+  struct Slot {
+    Block block;
+    uint32_t gen{0};
+    bool live{false};
+  };
+
+  // id -> slot, linear probing with backward-shift deletion (no tombstones)
+  struct IndexEntry {
+    int id;
+    uint32_t slot;
+  };
+  static constexpr int kEmptyId = INT32_MIN;
+
+  static uint32_t pageOf(uint32_t s) { return (uint32_t)std::bit_width((s >> kFirstPageBits) + 1) - 1; }
+  static uint32_t pageStart(uint32_t p) { return ((1u << p) - 1) << kFirstPageBits; }
+  static uint32_t pageSize(uint32_t p) { return 1u << (p + kFirstPageBits); }
+
+  Slot& slotAt(uint32_t s) { uint32_t p = pageOf(s); return pages_[p][s - pageStart(p)]; }
+  const Slot& slotAt(uint32_t s) const { uint32_t p = pageOf(s); return pages_[p][s - pageStart(p)]; }
+
+  uint32_t allocSlot();
+  uint32_t slotOf(int id) const;
+  size_t bucket(int id) const;
+  void indexInsert(int id, uint32_t slot);
+  void indexErase(int id);
+  void indexRehash(size_t capacity);
+
+  std::vector<std::unique_ptr<Slot[]>> pages_;
+  uint32_t used_{0};              // slots handed out so far (live + free)
+  std::vector<uint32_t> free_;    // erased slots, reused LIFO
+  size_t live_{0};
+
+  std::vector<IndexEntry> index_; // power-of-two capacity, or empty
+  size_t indexCount_{0};
+  uint32_t indexShift_{32};       // 32 - log2(capacity)
+};
@@ -0,0 +1,92 @@
+#include "model/CloneStore.h"
+
+#include "model/Sprite.h"
+
+void CloneStore::setCapacity(uint32_t n) {
+  parentId.assign(n, 0);
+  x.assign(n, 0.0f);
+  y.assign(n, 0.0f);
+  directionDeg.assign(n, 90.0f);
+  sizePercent.assign(n, 100.0f);
+  visible.assign(n, 1);
+  currentCostume.assign(n, 0);
+  soundVolume.assign(n, 100.0f);
+  soundPitch.assign(n, 0.0f);
+  sayText.assign(n, std::string());
+  sayTimeRemaining.assign(n, 0.0f);
+
+  gen_.assign(n, 0);
+  livePos_.assign(n, kFree);
+  live_.clear();
+  live_.reserve(n);
+  free_.clear();
+  free_.reserve(n);
+  for (uint32_t s = n; s-- > 0;) free_.push_back(s); // slot 0 handed out first
+}
+
+uint32_t CloneStore::take() {
+  if (free_.empty()) return kFree;
+  const uint32_t s = free_.back();
+  free_.pop_back();
+  livePos_[s] = (uint32_t)live_.size();
+  live_.push_back(s);
+  return s;
+}
+
+CloneStore::State CloneStore::stateOf(const Sprite& s) {
+  return State{s.id, s.x, s.y, s.directionDeg, s.sizePercent, s.visible, s.currentCostume,
+               s.soundVolume, s.soundPitch};
+}
+
+CloneStore::State CloneStore::stateOf(CloneHandle h) const {
+  const uint32_t f = h.slot;
+  return State{parentId[f], x[f], y[f], directionDeg[f], sizePercent[f], visible[f] != 0, currentCostume[f],
+               soundVolume[f], soundPitch[f]};
+}
+
+CloneHandle CloneStore::spawn(const State& from) {
+  const uint32_t s = take();
+  if (s == kFree) return {};
+
+  parentId[s] = from.parentId;
+  x[s] = from.x;
+  y[s] = from.y;
+  directionDeg[s] = from.directionDeg;
+  sizePercent[s] = from.sizePercent;
+  visible[s] = from.visible ? 1 : 0;
+  currentCostume[s] = from.currentCostume;
+  soundVolume[s] = from.soundVolume;
+  soundPitch[s] = from.soundPitch;
+  sayText[s].clear(); // keeps the capacity
+  sayTimeRemaining[s] = 0.0f;
+  return CloneHandle{s, gen_[s]};
+}
+
+void CloneStore::releaseSlot(uint32_t slot) {
+  // swap-remove from the live list
+  const uint32_t pos = livePos_[slot];
+  const uint32_t last = live_.back();
+  live_[pos] = last;
+  livePos_[last] = pos;
+  live_.pop_back();
+
+  livePos_[slot] = kFree;
+  ++gen_[slot];
+  free_.push_back(slot);
+}
+
+bool CloneStore::release(CloneHandle h) {
+  if (!alive(h)) return false;
+  releaseSlot(h.slot);
+  return true;
+}
+
+void CloneStore::releaseAll(int parent) {
+  for (size_t i = live_.size(); i-- > 0;) {
+    if (parentId[live_[i]] == parent) releaseSlot(live_[i]);
+  }
+}
+
+void CloneStore::clear() {
+  while (!live_.empty()) releaseSlot(live_.back());
+}
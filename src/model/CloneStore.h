@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Sprite;
+
+// Reference to a clone slot; goes stale (alive() == false) once the clone is
+// deleted, even if the slot has been reused since.
+struct CloneHandle {
+  uint32_t slot{UINT32_MAX};
+  uint32_t gen{0};
+
+  bool valid() const { return slot != UINT32_MAX; }
+  bool operator==(const CloneHandle& o) const { return slot == o.slot && gen == o.gen; }
+};
+
+// Clones made by "create clone of". A clone shares its sprite's scripts,
+// blocks, costumes and sounds; only the per-instance state below is its own,
+// kept as parallel arrays over a fixed pool of slots. Spawning takes a slot
+// off the free list and deleting puts it back, so neither allocates. When
+// the pool is full spawn() fails, like Scratch's clone limit.
+//
+// Transient: clones are not saved and go away on green flag / stop.
+class CloneStore {
+public:
+  static constexpr uint32_t kDefaultCapacity = 300;
+
+  CloneStore() { setCapacity(kDefaultCapacity); }
+
+  // resizes the pool; drops every clone
+  void setCapacity(uint32_t n);
+  uint32_t capacity() const { return (uint32_t)gen_.size(); }
+
+  size_t size() const { return live_.size(); }
+  bool empty() const { return live_.empty(); }
+
+  // what a new clone starts as: a copy of its sprite's or another clone's
+  // instance state
+  struct State {
+    int parentId{0};
+    float x{0.0f}, y{0.0f};
+    float directionDeg{90.0f};
+    float sizePercent{100.0f};
+    bool visible{true};
+    int currentCostume{0};
+    float soundVolume{100.0f};
+    float soundPitch{0.0f};
+  };
+  static State stateOf(const Sprite& s);
+  State stateOf(CloneHandle h) const; // h must be alive
+
+  // copy of a sprite, or of another clone (same parent sprite);
+  // an invalid handle when the pool is full or `from` is gone
+  CloneHandle spawn(const State& from);
+  CloneHandle spawn(const Sprite& from) { return spawn(stateOf(from)); }
+  CloneHandle spawn(CloneHandle from) { return alive(from) ? spawn(stateOf(from)) : CloneHandle{}; }
+
+  bool alive(CloneHandle h) const {
+    return h.slot < gen_.size() && gen_[h.slot] == h.gen && livePos_[h.slot] != kFree;
+  }
+  bool release(CloneHandle h);
+  void releaseAll(int parentId); // the sprite itself went away
+  void clear();
+
+  // live slots, in no particular order
+  const std::vector<uint32_t>& live() const { return live_; }
+  CloneHandle handle(uint32_t slot) const { return CloneHandle{slot, gen_[slot]}; }
+
+  // per-instance state by slot
+  std::vector<int> parentId;
+  std::vector<float> x, y;
+  std::vector<float> directionDeg;
+  std::vector<float> sizePercent;
+  std::vector<uint8_t> visible;
+  std::vector<int> currentCostume;
+  std::vector<float> soundVolume;
+  std::vector<float> soundPitch;
+  std::vector<std::string> sayText;
+  std::vector<float> sayTimeRemaining;
+
+private:
+  static constexpr uint32_t kFree = UINT32_MAX;
+
+  uint32_t take();
+  void releaseSlot(uint32_t slot);
+
+  std::vector<uint32_t> gen_;
+  std::vector<uint32_t> livePos_; // slot -> index in live_, or kFree
+  std::vector<uint32_t> live_;
+  std::vector<uint32_t> free_;    // reused LIFO, so a hot slot stays hot
+};
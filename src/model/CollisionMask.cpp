@@ -0,0 +1,48 @@
+#include "model/CollisionMask.h"
+
+#include <SDL.h>
+
+CollisionMask CollisionMask::fromSurface(SDL_Surface* surface, uint8_t alphaThreshold) {
+  CollisionMask m;
+  if (!surface) return m;
+
+  // RGBA32 is R,G,B,A in memory on every platform
+  SDL_Surface* s = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+  if (!s) return m;
+
+  m.width = s->w;
+  m.height = s->h;
+  m.wordsPerRow = (s->w + 63) / 64;
+  m.bits.assign((size_t)m.wordsPerRow * (size_t)s->h, 0);
+
+  SDL_LockSurface(s);
+  for (int y = 0; y < s->h; ++y) {
+    const Uint8* row = (const Uint8*)s->pixels + (size_t)y * (size_t)s->pitch;
+    uint64_t* out = &m.bits[(size_t)y * (size_t)m.wordsPerRow];
+    for (int x = 0; x < s->w; ++x) {
+      if (row[x * 4 + 3] >= alphaThreshold) out[x >> 6] |= (uint64_t)1 << (x & 63);
+    }
+  }
+  SDL_UnlockSurface(s);
+  SDL_FreeSurface(s);
+  return m;
+}
+
+const CollisionMask* CollisionMaskCache::find(const std::string& path) const {
+  auto it = masks_.find(path);
+  return it != masks_.end() ? &it->second : nullptr;
+}
+
+void CollisionMaskCache::put(const std::string& path, CollisionMask mask) {
+  masks_[path] = std::move(mask);
+  ++revision_;
+}
+
+void CollisionMaskCache::invalidate(const std::string& path) {
+  if (masks_.erase(path)) ++revision_;
+}
+
+void CollisionMaskCache::clear() {
+  masks_.clear();
+  ++revision_;
+}
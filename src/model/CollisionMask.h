@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct SDL_Surface;
+
+// One bit per costume pixel (set = opaque enough to collide), rows packed
+// into 64-bit words, row 0 at the top of the image.
+struct CollisionMask {
+  int width{0};
+  int height{0};
+  int wordsPerRow{0};
+  std::vector<uint64_t> bits;
+
+  bool empty() const { return width <= 0 || height <= 0; }
+  bool test(int x, int y) const {
+    return (bits[(size_t)y * (size_t)wordsPerRow + (size_t)(x >> 6)] >> (x & 63)) & 1u;
+  }
+
+  static CollisionMask fromSurface(SDL_Surface* surface, uint8_t alphaThreshold = 1);
+};
+
+// Costume masks by image path. TextureCache fills it when it loads an image;
+// the runtime reads it for "touching". revision() changes on every update so
+// readers can drop anything derived from an older mask.
+class CollisionMaskCache {
+public:
+  const CollisionMask* find(const std::string& path) const;
+  void put(const std::string& path, CollisionMask mask);
+  void invalidate(const std::string& path);
+  void clear();
+
+  uint64_t revision() const { return revision_; }
+
+private:
+  std::unordered_map<std::string, CollisionMask> masks_;
+  uint64_t revision_{0};
+};
@@ -1,12 +1,13 @@
 #pragma once
+#include <algorithm>
 #include <string>
 #include <vector>
 #include "Costume.h"
 #include "Sound.h"
 #include "Script.h"
 #include "model/Block.h"
+#include "model/BlockStore.h"
 #include "model/Script.h"
-#include <unordered_map>
 
 struct Sprite {
   int id{0};
@@ -32,16 +33,20 @@ struct Sprite {
   // Graphics effects (placeholder)
   float colorEffect{0};
 
-  const Costume* costume() const {
+  // side of the on-stage square the costume is stretched to, in stage units
+  float stageSize() const { return stageSizeFor(sizePercent); }
+  static float stageSizeFor(float percent) { return std::clamp(30.0f * (percent / 100.0f), 5.0f, 200.0f); }
+
+  const Costume* costume() const { return costumeAt(currentCostume); }
+  const Costume* costumeAt(int idx) const { // clones keep their own index
     if (costumes.empty()) return nullptr;
-    int idx = currentCostume;
     if (idx < 0 || idx >= (int)costumes.size()) idx = 0;
     return &costumes[idx];
   }
 
   // Scripts + Blocks (visual code)
   std::vector<Script> scripts;
-  std::unordered_map<int, Block> blocks; // blockId -> Block
+  BlockStore blocks; // blockId -> Block
 
   // editor selection
   int selectedScriptId{0};
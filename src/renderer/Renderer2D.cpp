@@ -1,5 +1,6 @@
 #include "Renderer2D.h"
 #include "core/Logger.h"
+#include "core/Trace.h"
 #include <algorithm>
 #include <cmath>
 
@@ -29,23 +30,30 @@ void Renderer2D::drawBackdrop(const Stage& stage, const SDL_FRect& rect) {
   SDL_RenderCopyF(r_, tex, nullptr, &dst);
 }
 
-void Renderer2D::drawSprite(const Sprite& sp, const SDL_FRect& stageRect) {
+void Renderer2D::drawSprite(const Sprite& sp, size_t index, const SDL_FRect& stageRect) {
   if (!sp.visible) return;
+  if (poses_) {
+    PoseHistory::Pose p = poses_->sprite(index, sp, alpha_);
+    drawCostume(sp.costume(), p.x, p.y, p.directionDeg, sp.stageSize(), stageRect);
+    return;
+  }
+  drawCostume(sp.costume(), sp.x, sp.y, sp.directionDeg, sp.stageSize(), stageRect);
+}
 
-  SDL_FPoint p = stageToScreen(sp.x, sp.y, stageRect);
+void Renderer2D::drawCostume(const Costume* c, float x, float y, float dirDeg, float side,
+                             const SDL_FRect& stageRect) {
+  SDL_FPoint p = stageToScreen(x, y, stageRect);
 
-  // placeholder size
-  float size = 30.0f * (sp.sizePercent / 100.0f);
-  size = std::clamp(size, 5.0f, 200.0f);
+  // stage units scaled like positions, so what's drawn is what collides
+  float size = side * (stageRect.w / 480.0f);
 
-  const Costume* c = sp.costume();
   SDL_Texture* tex = (c && cache_) ? cache_->get(c->imagePath) : nullptr;
 
   SDL_FRect dst{ p.x - size * 0.5f, p.y - size * 0.5f, size, size };
 
   if (tex) {
     // directionDeg: 90 یعنی راست، SDL angle: درجه و جهت ساعتگرد
-    double angle = -(sp.directionDeg - 90.0); // تقریب
+    double angle = -(dirDeg - 90.0); // تقریب
     SDL_RenderCopyExF(r_, tex, nullptr, &dst, angle, nullptr, SDL_FLIP_NONE);
   } else {
     // placeholder rect
@@ -57,13 +65,27 @@ void Renderer2D::drawSprite(const Sprite& sp, const SDL_FRect& stageRect) {
 }
 
 void Renderer2D::drawStage(const Project& project, const SDL_FRect& stageRect) {
+  Trace::Scope trace("Renderer2D::drawStage");
   drawBackdrop(project.stage(), stageRect);
 
   // stage border
   SDL_SetRenderDrawColor(r_, 200, 200, 200, 255);
   SDL_RenderDrawRectF(r_, &stageRect);
 
-  for (const auto& sp : project.sprites()) {
-    drawSprite(sp, stageRect);
+  // clones under the sprites (Scratch puts each just behind its parent)
+  const CloneStore& clones = project.clones();
+  for (uint32_t s : clones.live()) {
+    if (!clones.visible[s]) continue;
+    const Sprite* parent = project.findSpriteById(clones.parentId[s]);
+    if (!parent) continue;
+    PoseHistory::Pose p = poses_ ? poses_->clone(clones, s, alpha_)
+                                 : PoseHistory::Pose{clones.x[s], clones.y[s], clones.directionDeg[s]};
+    drawCostume(parent->costumeAt(clones.currentCostume[s]), p.x, p.y, p.directionDeg,
+                Sprite::stageSizeFor(clones.sizePercent[s]), stageRect);
+  }
+
+  const auto& sprites = project.sprites();
+  for (size_t i = 0; i < sprites.size(); ++i) {
+    drawSprite(sprites[i], i, stageRect);
   }
 }
\ No newline at end of file
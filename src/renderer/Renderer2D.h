@@ -2,6 +2,7 @@
 #include <SDL.h>
 #include "core/Project.h"
 #include "renderer/TextureCache.h"
+#include "runtime/PoseHistory.h"
 
 class Renderer2D {
 public:
@@ -10,10 +11,17 @@ public:
   // stageRect: جایی که stage در UI نمایش داده می‌شود (مختصات صفحه SDL)
   void drawStage(const Project& project, const SDL_FRect& stageRect);
 
+  // draw sprites `alpha` of the way from `poses` to where they are (the
+  // runtime's, set every frame); null: where they are
+  void setInterpolation(const PoseHistory* poses, float alpha) { poses_ = poses; alpha_ = alpha; }
+
 private:
   SDL_Renderer* r_{nullptr};
   TextureCache* cache_{nullptr};
+  const PoseHistory* poses_{nullptr};
+  float alpha_{1.0f};
 
   void drawBackdrop(const Stage& stage, const SDL_FRect& rect);
-  void drawSprite(const Sprite& sp, const SDL_FRect& rect);
+  void drawSprite(const Sprite& sp, size_t index, const SDL_FRect& rect);
+  void drawCostume(const Costume* c, float x, float y, float dirDeg, float side, const SDL_FRect& stageRect);
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <SDL_image.h>
 #include "core/Logger.h"
+#include "core/Trace.h"
 
 TextureCache::~TextureCache() {
   clear();
@@ -19,6 +20,7 @@ void TextureCache::invalidate(const std::string& path) {
   if (it == cache_.end()) return;
   if (it->second) SDL_DestroyTexture(it->second);
   cache_.erase(it);
+  if (masks_) masks_->invalidate(path);
 }
 
 SDL_Texture* TextureCache::get(const std::string& path) {
@@ -27,16 +29,24 @@ SDL_Texture* TextureCache::get(const std::string& path) {
   auto it = cache_.find(path);
   if (it != cache_.end()) return it->second;
 
-  // ✅ PNG/JPG/BMP/... via SDL_image
-  SDL_Texture* tex = IMG_LoadTexture(r_, path.c_str());
+  Trace::Scope trace("TextureCache miss");
+
+  // ✅ PNG/JPG/BMP/... via SDL_image; decoded to a surface first so the
+  // collision mask comes from the same pixels
+  SDL_Surface* surf = IMG_Load(path.c_str());
+  SDL_Texture* tex = surf ? SDL_CreateTextureFromSurface(r_, surf) : nullptr;
   if (!tex) {
     Logger::error("TextureCache",
-                  std::string("IMG_LoadTexture failed for '") + path +
+                  std::string("IMG_Load failed for '") + path +
                   "': " + IMG_GetError());
+    if (surf) SDL_FreeSurface(surf);
     cache_[path] = nullptr;
     return nullptr;
   }
 
+  if (masks_) masks_->put(path, CollisionMask::fromSurface(surf));
+  SDL_FreeSurface(surf);
+
   cache_[path] = tex;
   return tex;
 }
\ No newline at end of file
@@ -3,9 +3,12 @@
 #include <string>
 #include <unordered_map>
 
+#include "model/CollisionMask.h"
+
 class TextureCache {
 public:
-  explicit TextureCache(SDL_Renderer* r) : r_(r) {}
+  // masks (optional): gets a collision mask for every image loaded here
+  explicit TextureCache(SDL_Renderer* r, CollisionMaskCache* masks = nullptr) : r_(r), masks_(masks) {}
   ~TextureCache();
 
   SDL_Texture* get(const std::string& path);
@@ -14,5 +17,6 @@ public:
 
 private:
   SDL_Renderer* r_{nullptr};
+  CollisionMaskCache* masks_{nullptr};
   std::unordered_map<std::string, SDL_Texture*> cache_;
 };
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "runtime/Collision.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SCRATCHY_COLLISION_SSE2 1
+#endif
+
+#include "model/CollisionMask.h"
+
+namespace {
+
+// Does any bit of `b` overlap `a` when b's bit k sits over a's bit k + off?
+// Rows carry two words of zero padding, so reading a[q + 2] is always safe.
+bool rowsOverlap(const uint64_t* a, int aWords, const uint64_t* b, int bWords, int off) {
+  const int q0 = off >> 6;
+  const int s = off & 63;
+  int w = 0;
+
+#if SCRATCHY_COLLISION_SSE2
+  const __m128i sh = _mm_cvtsi32_si128(s);
+  const __m128i shInv = _mm_cvtsi32_si128(64 - s); // 64 shifts to zero when s == 0
+  const __m128i zero = _mm_setzero_si128();
+  for (; w + 1 < bWords && w + q0 < aWords; w += 2) {
+    const uint64_t* p = a + w + q0;
+    __m128i lo = _mm_loadu_si128((const __m128i*)p);
+    __m128i hi = _mm_loadu_si128((const __m128i*)(p + 1));
+    __m128i aw = _mm_or_si128(_mm_srl_epi64(lo, sh), _mm_sll_epi64(hi, shInv));
+    __m128i hit = _mm_and_si128(aw, _mm_loadu_si128((const __m128i*)(b + w)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(hit, zero)) != 0xFFFF) return true;
+  }
+#endif
+
+  for (; w < bWords && w + q0 < aWords; ++w) {
+    const uint64_t* p = a + w + q0;
+    uint64_t aw = s ? (p[0] >> s) | (p[1] << (64 - s)) : p[0];
+    if (aw & b[w]) return true;
+  }
+  return false;
+}
+
+} // namespace
+
+namespace Collision {
+
+int extentFor(float side) {
+  return (int)std::ceil(side * 0.5f * 1.41421356f); // half diagonal
+}
+
+// columns dx where lo <= base + k*dx <= hi, intersected into [*from, *to]
+static void clipSpan(float base, float k, float lo, float hi, float* from, float* to) {
+  if (std::fabs(k) < 1e-6f) {
+    if (base < lo || base > hi) { *from = 1.0f; *to = 0.0f; }
+    return;
+  }
+  float a = (lo - base) / k;
+  float b = (hi - base) / k;
+  if (a > b) std::swap(a, b);
+  *from = std::max(*from, a);
+  *to = std::min(*to, b);
+}
+
+void build(Footprint& fp, const CollisionMask* mask, float side, float dirDeg) {
+  const int r = extentFor(side);
+  const int dim = 2 * r + 1;
+  fp.extent = r;
+  fp.words = (dim + 63) / 64;
+  fp.stride = fp.words + 2;
+  fp.bits.assign((size_t)fp.stride * (size_t)dim, 0);
+  fp.empty = true;
+
+  const bool useMask = mask && !mask->empty();
+  const float half = side * 0.5f;
+  const float sx = useMask ? (float)mask->width / side : 0.0f;
+  const float sy = useMask ? (float)mask->height / side : 0.0f;
+  // same rotation the renderer applies (see Renderer2D::drawSprite)
+  const float th = (dirDeg - 90.0f) * 3.1415926f / 180.0f;
+  const float c = std::cos(th);
+  const float s = std::sin(th);
+
+  for (int row = 0; row < dim; ++row) {
+    const float dy = (float)(row - r);
+    // costume-local (u, v) = inverse rotation of (dx, dy); both are linear in
+    // dx, so the inside of the square is one span per row
+    const float u0 = dy * s;
+    const float v0 = dy * c;
+    float from = (float)-r, to = (float)r;
+    clipSpan(u0, c, -half, half, &from, &to);
+    clipSpan(v0, -s, -half, half, &from, &to);
+    const int x0 = std::max(-r, (int)std::ceil(from));
+    const int x1 = std::min(r, (int)std::floor(to));
+    if (x0 > x1) continue;
+
+    uint64_t* out = fp.bits.data() + (size_t)row * (size_t)fp.stride;
+    int first = INT32_MAX, last = INT32_MIN;
+
+    if (!useMask) {
+      for (int x = x0; x <= x1; ++x) out[(x + r) >> 6] |= (uint64_t)1 << ((x + r) & 63);
+      first = x0;
+      last = x1;
+    } else {
+      float u = u0 + c * (float)x0;
+      float v = v0 - s * (float)x0;
+      for (int x = x0; x <= x1; ++x, u += c, v -= s) {
+        int mx = std::clamp((int)((u + half) * sx), 0, mask->width - 1);
+        int my = std::clamp((int)((half - v) * sy), 0, mask->height - 1);
+        if (!mask->test(mx, my)) continue;
+        out[(x + r) >> 6] |= (uint64_t)1 << ((x + r) & 63);
+        first = std::min(first, x);
+        last = x;
+      }
+      if (first > last) continue;
+    }
+
+    const int y = row - r;
+    if (fp.empty) {
+      fp.minX = first; fp.maxX = last;
+      fp.minY = fp.maxY = y;
+      fp.empty = false;
+    } else {
+      fp.minX = std::min(fp.minX, first); fp.maxX = std::max(fp.maxX, last);
+      fp.maxY = y; // rows go bottom to top
+    }
+  }
+}
+
+bool overlap(const Footprint& a, int ax, int ay, const Footprint& b, int bx, int by) {
+  if (a.empty || b.empty) return false;
+
+  // tight bounds first; most pairs stop here
+  if (ax + a.maxX < bx + b.minX || bx + b.maxX < ax + a.minX) return false;
+  if (ay + a.maxY < by + b.minY || by + b.maxY < ay + a.minY) return false;
+
+  const Footprint* pa = &a;
+  const Footprint* pb = &b;
+  int aLeft = ax - a.extent, aBottom = ay - a.extent;
+  int bLeft = bx - b.extent, bBottom = by - b.extent;
+  if (bLeft < aLeft) {
+    std::swap(pa, pb);
+    std::swap(aLeft, bLeft);
+    std::swap(aBottom, bBottom);
+    std::swap(ax, bx);
+    std::swap(ay, by);
+  }
+  const int off = bLeft - aLeft; // b's column k is a's column k + off
+
+  const int y0 = std::max(ay + pa->minY, by + pb->minY);
+  const int y1 = std::min(ay + pa->maxY, by + pb->maxY);
+  for (int y = y0; y <= y1; ++y) {
+    if (rowsOverlap(pa->row(y - aBottom), pa->words, pb->row(y - bBottom), pb->words, off)) return true;
+  }
+  return false;
+}
+
+bool contains(const Footprint& fp, int cx, int cy, int px, int py) {
+  if (fp.empty) return false;
+  const int col = px - (cx - fp.extent);
+  const int row = py - (cy - fp.extent);
+  const int dim = 2 * fp.extent + 1;
+  if (col < 0 || row < 0 || col >= dim || row >= dim) return false;
+  return (fp.row(row)[col >> 6] >> (col & 63)) & 1u;
+}
+
+} // namespace Collision
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct CollisionMask;
+
+// Pixel-accurate sprite collision on the stage pixel grid (1 stage unit =
+// 1 pixel). A sprite's costume mask is rotated and scaled into a Footprint
+// once per costume/size/direction change; "touching" is then a bounds check
+// plus a shifted AND of the two footprints' bit rows.
+namespace Collision {
+
+  struct Footprint {
+    int extent{0};  // bitmap covers center +- extent on both axes
+    int words{0};   // words of real bits per row
+    int stride{0};  // words per row incl. zero padding for unaligned reads
+    std::vector<uint64_t> bits; // row 0 = center.y - extent
+
+    // tight bounds of the set bits, relative to the center; empty if none
+    bool empty{true};
+    int minX{0}, minY{0}, maxX{0}, maxY{0};
+
+    const uint64_t* row(int r) const { return bits.data() + (size_t)r * (size_t)stride; }
+  };
+
+  // side: sprite size in stage units (the costume is stretched to a side x
+  // side square), dirDeg: sprite direction. A null/empty mask fills the square.
+  void build(Footprint& fp, const CollisionMask* mask, float side, float dirDeg);
+
+  // footprints placed with their centers at integer stage coordinates
+  bool overlap(const Footprint& a, int ax, int ay, const Footprint& b, int bx, int by);
+  bool contains(const Footprint& fp, int cx, int cy, int px, int py);
+
+  // half size of the bitmap for a given side, independent of rotation
+  int extentFor(float side);
+}
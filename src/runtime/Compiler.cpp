@@ -0,0 +1,191 @@
+#include "runtime/Compiler.h"
+
+#include <cctype>
+#include <unordered_set>
+
+#include "core/Project.h"
+#include "runtime/Messages.h"
+
+namespace {
+
+void setString(Program& prog, Instr& in, const Block& b, const char* def) {
+  const std::string& v = b.args.empty() ? std::string(def) : b.args[0];
+  if (in.str < 0) {
+    prog.strings.push_back(v);
+    in.str = (int)prog.strings.size() - 1;
+  } else {
+    prog.strings[(size_t)in.str] = v;
+  }
+}
+
+void setCondition(Program& prog, Instr& in, const Block& b, const Project& project) {
+  Condition c = Conditions::forBlock(b);
+  Conditions::resolve(c, project);
+  if (in.cond < 0) {
+    prog.conds.push_back(std::move(c));
+    in.cond = (int)prog.conds.size() - 1;
+  } else {
+    prog.conds[(size_t)in.cond] = std::move(c);
+  }
+}
+
+// "myself" -> 0, otherwise resolved by name when compiled (like Condition
+// sprite targets)
+int cloneTarget(const Block& b, const Project& project) {
+  std::string name = b.args.empty() ? std::string("myself") : b.args[0];
+  for (char& c : name) c = (char)std::tolower((unsigned char)c);
+  if (name.empty() || name == "myself") return 0;
+  const Sprite* sp = project.findSpriteByLowerName(name);
+  return sp ? sp->id : -1;
+}
+
+// Operands come from the block's parsed arg cache. Used at compile time and
+// again by refreshOperands() after an edit, so it must not change layout.
+void loadOperands(Program& prog, Instr& in, const Block& b, const Project& project) {
+  switch (b.type) {
+    case BlockType::MoveSteps:      in.num[0] = b.argNumber(0, 10.0f); break;
+    case BlockType::TurnRight:
+    case BlockType::TurnLeft:       in.num[0] = b.argNumber(0, 15.0f); break;
+    case BlockType::GoToXY:         in.num[0] = b.argNumber(0, 0.0f); in.num[1] = b.argNumber(1, 0.0f); break;
+    case BlockType::SetX:
+    case BlockType::SetY:           in.num[0] = b.argNumber(0, 0.0f); break;
+    case BlockType::ChangeXBy:
+    case BlockType::ChangeYBy:      in.num[0] = b.argNumber(0, 10.0f); break;
+    case BlockType::Say:            setString(prog, in, b, "Hello!"); break;
+    case BlockType::Think:          setString(prog, in, b, "Hmm..."); break;
+    case BlockType::WaitSeconds:    in.num[0] = b.argNumber(0, 1.0f); break;
+    case BlockType::Repeat:         in.num[0] = b.argNumber(0, 10.0f); break;
+    case BlockType::WaitUntil:
+    case BlockType::IfThen:
+    case BlockType::RepeatUntil:    setCondition(prog, in, b, project); break;
+    case BlockType::AskAndWait:     setString(prog, in, b, "?"); break;
+    case BlockType::PlaySound:
+    case BlockType::PlaySoundUntilDone: setString(prog, in, b, ""); break;
+    case BlockType::SetVolumeTo:    in.num[0] = b.argNumber(0, 100.0f); break;
+    case BlockType::ChangeVolumeBy: in.num[0] = b.argNumber(0, 10.0f); break;
+    case BlockType::SetPitchTo:     in.num[0] = b.argNumber(0, 0.0f); break;
+    case BlockType::ChangePitchBy:  in.num[0] = b.argNumber(0, 1.0f); break;
+    case BlockType::Broadcast:
+    case BlockType::BroadcastAndWait: in.msg = Messages::intern(b.args.empty() ? std::string() : b.args[0]); break;
+    case BlockType::CreateCloneOf:  in.sprite = cloneTarget(b, project); break;
+    default: break;
+  }
+}
+
+struct Emitter {
+  const Project& project;
+  const Sprite& sp;
+  Program& prog;
+  std::unordered_set<int> visited; // guards against cyclic links in broken files
+
+  int pc() const { return (int)prog.code.size(); }
+
+  int emit(const Instr& in) {
+    prog.code.push_back(in);
+    return pc() - 1;
+  }
+
+  void chain(int headId) {
+    int cur = headId;
+    while (cur != -1) {
+      const Block* b = sp.blocks.find(cur);
+      if (!b) break;
+      if (!visited.insert(cur).second) break;
+      block(*b);
+      cur = b->nextId;
+    }
+  }
+
+  void block(const Block& b) {
+    if (isHatBlock(b.type)) return;
+
+    Instr in;
+    in.type = b.type;
+    in.blockId = b.id;
+    loadOperands(prog, in, b, project);
+
+    switch (b.type) {
+      case BlockType::Repeat: {
+        in.op = OpCode::RepeatInit;
+        int init = emit(in);
+        int bodyStart = pc();
+        chain(b.childHeadId);
+        if (pc() == bodyStart) { prog.code.pop_back(); return; } // empty body: no-op
+
+        Instr next = in;
+        next.op = OpCode::RepeatNext;
+        next.target = bodyStart;
+        emit(next);
+        prog.code[(size_t)init].target = pc();
+        return;
+      }
+
+      case BlockType::Forever: {
+        int bodyStart = pc();
+        chain(b.childHeadId);
+        if (pc() == bodyStart) return; // empty body: no-op
+
+        in.op = OpCode::Jump;
+        in.target = bodyStart;
+        emit(in);
+        return;
+      }
+
+      case BlockType::IfThen: {
+        in.op = OpCode::IfFalseJump;
+        int test = emit(in);
+        chain(b.childHeadId);
+        prog.code[(size_t)test].target = pc();
+        return;
+      }
+
+      case BlockType::RepeatUntil: {
+        in.op = OpCode::IfTrueJump;
+        int test = emit(in);
+        chain(b.childHeadId);
+        if (pc() == test + 1) { prog.code.pop_back(); return; } // empty body: no-op
+
+        Instr back = in;
+        back.op = OpCode::Jump;
+        back.cond = -1;
+        back.target = test;
+        emit(back);
+        prog.code[(size_t)test].target = pc();
+        return;
+      }
+
+      default:
+        break;
+    }
+
+    in.op = OpCode::Exec;
+    emit(in);
+  }
+};
+
+} // namespace
+
+namespace Compiler {
+
+std::shared_ptr<Program> compileScript(const Project& project, const Sprite& sp, const Script& sc) {
+  auto prog = std::make_shared<Program>();
+  prog->spriteId = sp.id;
+  prog->scriptId = sc.id;
+
+  Emitter em{project, sp, *prog, {}};
+  em.chain(sc.headBlockId);
+
+  Instr end;
+  end.op = OpCode::End;
+  em.emit(end);
+  return prog;
+}
+
+void refreshOperands(Program& prog, const Project& project, const Sprite& sp) {
+  for (Instr& in : prog.code) {
+    if (in.op == OpCode::Jump || in.op == OpCode::RepeatNext || in.op == OpCode::End) continue;
+    if (const Block* b = sp.blocks.find(in.blockId)) loadOperands(prog, in, *b, project);
+  }
+}
+
+} // namespace Compiler
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "model/Block.h"
+#include "runtime/Condition.h"
+#include "model/Script.h"
+#include "model/Sprite.h"
+
+class Project;
+
+// Flat instruction stream compiled from a script's nextId/childHeadId graph.
+// Control blocks become jumps with resolved offsets, so the runner never
+// touches Sprite::blocks while executing.
+enum class OpCode : uint8_t {
+  Exec,         // run block `type`, then fall through
+  Jump,         // pc = target (free: no step consumed)
+  RepeatInit,   // push counter num[0]; if <= 0 jump to target (loop exit)
+  RepeatNext,   // --counter; > 0 -> jump to target (body start), else pop (free)
+  IfFalseJump,  // if then: condition false -> jump to target
+  IfTrueJump,   // repeat until: condition true -> jump to target (loop exit)
+  End,          // script finished
+};
+
+struct Instr {
+  OpCode op{OpCode::Exec};
+  BlockType type{BlockType::MoveSteps};
+  int blockId{-1};
+  int target{-1};      // jump destination (pc)
+  int str{-1};         // index into Program::strings (text / sound arg)
+  int cond{-1};        // index into Program::conds
+  int msg{-1};         // interned message id (Broadcast*), see runtime/Messages.h
+  int sprite{0};       // CreateCloneOf: sprite id, 0 = myself, -1 = no such sprite
+  float num[2]{0, 0};  // numeric args, from Block's parsed arg cache
+};
+
+struct Program {
+  int spriteId{0};
+  int scriptId{0};
+  std::vector<Instr> code;          // always terminated by OpCode::End
+  std::vector<std::string> strings;
+  std::vector<Condition> conds;     // sprite targets resolved at compile time
+};
+
+namespace Compiler {
+  std::shared_ptr<Program> compileScript(const Project& project, const Sprite& sp, const Script& sc);
+
+  // Re-read numeric/string operands from the blocks' parsed arg cache after an
+  // edit. Layout (and therefore every runner's pc) is left untouched.
+  void refreshOperands(Program& prog, const Project& project, const Sprite& sp);
+}
@@ -0,0 +1,175 @@
+#include "runtime/Condition.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+
+#include "core/Project.h"
+#include "model/Block.h"
+
+namespace {
+
+std::string trim(std::string s) {
+  auto notSpace = [](unsigned char c) { return !std::isspace(c); };
+  s.erase(s.begin(), std::find_if(s.begin(), s.end(), notSpace));
+  s.erase(std::find_if(s.rbegin(), s.rend(), notSpace).base(), s.end());
+  return s;
+}
+
+std::string lower(std::string s) {
+  for (char& c : s) c = (char)std::tolower((unsigned char)c);
+  return s;
+}
+
+bool startsWith(const std::string& s, const char* p) {
+  return s.rfind(p, 0) == 0;
+}
+
+float toFloat(const std::string& s, float def) {
+  if (s.empty()) return def;
+  char* end = nullptr;
+  float v = std::strtof(s.c_str(), &end);
+  if (end == s.c_str()) return def;
+  return v;
+}
+
+// "<op> <number>" -> op/value
+bool parseComparison(std::string rest, CmpOp* outOp, float* outValue) {
+  static const struct { const char* text; CmpOp op; } ops[] = {
+    {"<=", CmpOp::Le}, {">=", CmpOp::Ge}, {"==", CmpOp::Eq},
+    {"!=", CmpOp::Ne}, {"<", CmpOp::Lt}, {">", CmpOp::Gt},
+  };
+  rest = trim(rest);
+  for (const auto& o : ops) {
+    if (startsWith(rest, o.text)) {
+      float v = toFloat(trim(rest.substr(std::char_traits<char>::length(o.text))), NAN);
+      if (std::isnan(v)) return false;
+      *outOp = o.op;
+      *outValue = v;
+      return true;
+    }
+  }
+  return false;
+}
+
+// sprite target by name, falling back to a 1-based index
+void setTarget(Condition& c, const std::string& t) {
+  c.targetName = t;
+  char* end = nullptr;
+  long idx = std::strtol(t.c_str(), &end, 10);
+  if (end && end != t.c_str() && *end == '\0') c.targetIndex = (int)idx;
+}
+
+} // namespace
+
+namespace Conditions {
+
+SDL_Scancode scancodeFromName(const std::string& name) {
+  std::string key = trim(lower(name));
+  if (key.size() > 6 && key.compare(key.size() - 6, 6, " arrow") == 0) key.resize(key.size() - 6); // Scratch spelling
+  if (key == "space") return SDL_SCANCODE_SPACE;
+  if (key == "left")  return SDL_SCANCODE_LEFT;
+  if (key == "right") return SDL_SCANCODE_RIGHT;
+  if (key == "up")    return SDL_SCANCODE_UP;
+  if (key == "down")  return SDL_SCANCODE_DOWN;
+  if (key == "enter") return SDL_SCANCODE_RETURN;
+  if (key.size() == 1 && key[0] >= 'a' && key[0] <= 'z') {
+    return (SDL_Scancode)(SDL_SCANCODE_A + (key[0] - 'a'));
+  }
+  if (key.size() == 1 && key[0] >= '1' && key[0] <= '9') {
+    return (SDL_Scancode)(SDL_SCANCODE_1 + (key[0] - '1'));
+  }
+  if (key == "0") return SDL_SCANCODE_0;
+  return SDL_SCANCODE_UNKNOWN;
+}
+
+Condition compile(const std::string& expr) {
+  using Kind = Condition::Kind;
+  Condition c;
+
+  std::string s = trim(lower(expr));
+  if (s.empty() || s == "true") { c.kind = Kind::True; return c; }
+  if (s == "false" || s == "0") { c.kind = Kind::False; return c; }
+
+  if (startsWith(s, "touching ")) {
+    std::string t = trim(s.substr(std::string("touching ").size()));
+    if (t.empty())        c.kind = Kind::False;
+    else if (t == "edge")  c.kind = Kind::TouchingEdge;
+    else if (t == "mouse") c.kind = Kind::TouchingMouse;
+    else { c.kind = Kind::TouchingSprite; setTarget(c, t); }
+    return c;
+  }
+
+  if (startsWith(s, "key ")) {
+    c.key = scancodeFromName(s.substr(4));
+    c.kind = (c.key != SDL_SCANCODE_UNKNOWN) ? Kind::KeyDown : Kind::False;
+    return c;
+  }
+
+  if (s == "mouse down") { c.kind = Kind::MouseDown; return c; }
+
+  // distance to <target> <op> <value>
+  if (startsWith(s, "distance to ")) {
+    std::string rest = s.substr(std::string("distance to ").size());
+    size_t sp1 = rest.find(' ');
+    if (sp1 != std::string::npos && parseComparison(rest.substr(sp1), &c.op, &c.value)) {
+      std::string t = trim(rest.substr(0, sp1));
+      if (t == "mouse") c.kind = Kind::DistanceToMouse;
+      else { c.kind = Kind::DistanceToSprite; setTarget(c, t); }
+      return c;
+    }
+  }
+
+  // mouse x / mouse y <op> <value>
+  if (startsWith(s, "mouse x") && parseComparison(s.substr(7), &c.op, &c.value)) {
+    c.kind = Kind::MouseX;
+    return c;
+  }
+  if (startsWith(s, "mouse y") && parseComparison(s.substr(7), &c.op, &c.value)) {
+    c.kind = Kind::MouseY;
+    return c;
+  }
+
+  // fallback: treat as truthy string
+  c = Condition{};
+  c.kind = Kind::True;
+  return c;
+}
+
+const Condition& forBlock(const Block& b) {
+  static const Condition kEmpty{};
+  const BlockArg* a = b.arg(0);
+  if (!a) return kEmpty;
+  if (!a->cond) a->cond = std::make_shared<const Condition>(compile(b.args[0]));
+  return *a->cond;
+}
+
+void resolve(Condition& c, const Project& project) {
+  c.targetSpriteId = 0;
+  if (c.kind != Condition::Kind::TouchingSprite && c.kind != Condition::Kind::DistanceToSprite) return;
+
+  if (const Sprite* other = project.findSpriteByLowerName(c.targetName)) {
+    c.targetSpriteId = other->id;
+    return;
+  }
+  const auto& sprites = project.sprites();
+  if (c.targetIndex >= 1 && c.targetIndex <= (int)sprites.size()) {
+    c.targetSpriteId = sprites[(size_t)(c.targetIndex - 1)].id;
+  }
+}
+
+bool compare(float a, CmpOp op, float b) {
+  switch (op) {
+    case CmpOp::Lt: return a < b;
+    case CmpOp::Le: return a <= b;
+    case CmpOp::Gt: return a > b;
+    case CmpOp::Ge: return a >= b;
+    case CmpOp::Eq: return a == b;
+    case CmpOp::Ne: return a != b;
+  }
+  return false;
+}
+
+} // namespace Conditions
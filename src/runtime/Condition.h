@@ -0,0 +1,54 @@
+#pragma once
+#include <SDL.h>
+
+#include <cstdint>
+#include <string>
+
+class Project;
+struct Block;
+
+enum class CmpOp : uint8_t { Lt, Le, Gt, Ge, Eq, Ne };
+
+// Pre-parsed form of a condition expression such as "touching edge",
+// "key space" or "distance to Sprite2 < 50". Evaluating one never allocates.
+struct Condition {
+  enum class Kind : uint8_t {
+    True,
+    False,
+    TouchingEdge,
+    TouchingMouse,
+    TouchingSprite,
+    KeyDown,
+    MouseDown,
+    DistanceToMouse,
+    DistanceToSprite,
+    MouseX,
+    MouseY,
+  };
+
+  Kind kind{Kind::True};
+  CmpOp op{CmpOp::Lt};
+  float value{0.0f};
+  SDL_Scancode key{SDL_SCANCODE_UNKNOWN};
+
+  // sprite target: lowered name, or 1-based index when the name is numeric
+  std::string targetName;
+  int targetIndex{-1};
+  int targetSpriteId{0}; // filled by resolve(); 0 = no such sprite
+};
+
+namespace Conditions {
+  Condition compile(const std::string& expr);
+
+  // compiled condition for the block's first arg, cached on the block until
+  // its args are edited
+  const Condition& forBlock(const Block& b);
+
+  // bind sprite targets to sprite ids (done once per compiled program)
+  void resolve(Condition& c, const Project& project);
+
+  bool compare(float a, CmpOp op, float b);
+
+  // "space", "left", "a".."z" ... -> scancode (SDL_SCANCODE_UNKNOWN if unknown)
+  SDL_Scancode scancodeFromName(const std::string& name);
+}
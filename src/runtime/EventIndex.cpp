@@ -0,0 +1,91 @@
+#include "runtime/EventIndex.h"
+
+#include <cctype>
+
+#include "core/Project.h"
+#include "runtime/Condition.h"
+#include "runtime/Messages.h"
+
+void EventIndex::clear() {
+  greenFlag_.clear();
+  for (auto& k : keys_) k.clear();
+  anyKey_.clear();
+  receivers_.clear();
+  cloneHats_.clear();
+  built_ = false;
+}
+
+void EventIndex::sync(const Project& project) {
+  if (built_ && scriptsRevision_ == project.scriptsRevision() && linksRevision_ == project.linksRevision() &&
+      argsRevision_ == project.argsRevision()) {
+    return;
+  }
+  rebuild(project);
+}
+
+void EventIndex::rebuild(const Project& project) {
+  // args-only edits keep the compiled programs: Runtime patches their
+  // operands in place (refreshEditedOperands)
+  std::unordered_map<int, std::shared_ptr<Program>> kept; // by script id
+  if (built_ && scriptsRevision_ == project.scriptsRevision() && linksRevision_ == project.linksRevision()) {
+    auto keep = [&](std::vector<Hat>& hats) {
+      for (Hat& h : hats) {
+        if (h.program) kept[h.scriptId] = std::move(h.program);
+      }
+    };
+    keep(greenFlag_);
+    for (auto& k : keys_) keep(k);
+    keep(anyKey_);
+    for (auto& kv : receivers_) keep(kv.second);
+    for (auto& kv : cloneHats_) keep(kv.second);
+  }
+  clear();
+
+  // sprite order, then script order: the order runners start in
+  for (const auto& sp : project.sprites()) {
+    for (const auto& sc : sp.scripts) {
+      const Block* head = sp.blocks.find(sc.headBlockId);
+      if (!head) continue;
+
+      Hat hat{sp.id, sc.id, nullptr};
+      if (auto it = kept.find(sc.id); it != kept.end()) hat.program = std::move(it->second);
+      if (head->type == BlockType::WhenGreenFlag) {
+        greenFlag_.push_back(std::move(hat));
+      } else if (head->type == BlockType::WhenKeyPressed) {
+        std::string key = head->args.empty() ? std::string("space") : head->args[0];
+        for (char& c : key) c = (char)std::tolower((unsigned char)c);
+        if (key == "any") {
+          anyKey_.push_back(std::move(hat));
+        } else {
+          SDL_Scancode code = Conditions::scancodeFromName(key);
+          if (code != SDL_SCANCODE_UNKNOWN) keys_[(size_t)code].push_back(std::move(hat));
+        }
+      } else if (head->type == BlockType::WhenIReceive) {
+        const int msg = Messages::intern(head->args.empty() ? std::string("message1") : head->args[0]);
+        receivers_[msg].push_back(std::move(hat));
+      } else if (head->type == BlockType::WhenIStartAsClone) {
+        cloneHats_[sp.id].push_back(std::move(hat));
+      }
+    }
+  }
+
+  built_ = true;
+  scriptsRevision_ = project.scriptsRevision();
+  linksRevision_ = project.linksRevision();
+  argsRevision_ = project.argsRevision();
+}
+
+std::vector<EventIndex::Hat>& EventIndex::received(int message) {
+  auto it = receivers_.find(message);
+  return it != receivers_.end() ? it->second : none_;
+}
+
+std::vector<EventIndex::Hat>& EventIndex::cloneStarted(int spriteId) {
+  auto it = cloneHats_.find(spriteId);
+  return it != cloneHats_.end() ? it->second : none_;
+}
+
+std::vector<EventIndex::Hat>& EventIndex::keyPressed(SDL_Scancode sc) {
+  if ((int)sc <= 0 || (int)sc >= (int)keys_.size()) return none_;
+  return keys_[(size_t)sc];
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <SDL.h>
+
+#include "runtime/Compiler.h"
+
+class Project;
+
+// Hat scripts grouped by the event that starts them, so firing an event costs
+// O(matching hats) instead of a scan over every sprite's scripts.
+//
+// Rebuilt by sync() only when the project's scripts, block links or block
+// args changed (see Project::scriptsRevision/linksRevision/argsRevision).
+// Programs are compiled the first time a hat fires and kept until a script
+// or link changes; a rebuild for edited args keeps them.
+class EventIndex {
+public:
+  struct Hat {
+    int spriteId{0};
+    int scriptId{0};
+    std::shared_ptr<Program> program; // null until first started
+  };
+
+  void sync(const Project& project);
+  void clear();
+
+  std::vector<Hat>& greenFlag() { return greenFlag_; }
+  std::vector<Hat>& keyPressed(SDL_Scancode sc);
+  std::vector<Hat>& anyKeyPressed() { return anyKey_; }
+  std::vector<Hat>& received(int message); // "when I receive", by Messages id
+  std::vector<Hat>& cloneStarted(int spriteId); // "when I start as a clone"
+
+private:
+  void rebuild(const Project& project);
+
+  bool built_{false};
+  uint64_t scriptsRevision_{0};
+  uint64_t linksRevision_{0};
+  uint64_t argsRevision_{0};
+
+  std::vector<Hat> greenFlag_;
+  std::array<std::vector<Hat>, SDL_NUM_SCANCODES> keys_;
+  std::vector<Hat> anyKey_;
+  std::unordered_map<int, std::vector<Hat>> receivers_;
+  std::unordered_map<int, std::vector<Hat>> cloneHats_; // by sprite id
+  std::vector<Hat> none_;
+};
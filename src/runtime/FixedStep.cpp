@@ -0,0 +1,33 @@
+#include "runtime/FixedStep.h"
+
+#include <algorithm>
+#include <cmath>
+
+double FixedStep::tickSeconds() const {
+  return 1.0 / std::clamp(config_.ticksPerSecond, 1, 1000);
+}
+
+int FixedStep::advance(double frameSeconds) {
+  const double tick = tickSeconds();
+  const int maxTicks = std::clamp(config_.maxTicksPerFrame, 1, 100);
+
+  accumulator_ += std::max(0.0, frameSeconds);
+  int ticks = (int)std::min(std::floor(accumulator_ / tick), (double)maxTicks + 1.0);
+  if (ticks > maxTicks) {
+    // too far behind: run the limit and keep less than one tick of the rest
+    const double behind = accumulator_ - maxTicks * tick;
+    dropped_ += (uint64_t)(behind / tick);
+    accumulator_ = std::fmod(behind, tick);
+    return maxTicks;
+  }
+  accumulator_ -= ticks * tick;
+  return ticks;
+}
+
+void FixedStep::reset() {
+  accumulator_ = 0.0;
+}
+
+float FixedStep::alpha() const {
+  return (float)std::clamp(accumulator_ / tickSeconds(), 0.0, 1.0);
+}
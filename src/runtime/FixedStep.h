@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+
+// Fixed-rate simulation clock. The app feeds it each frame's real duration
+// and runs as many ticks of tickSeconds() as have built up, so scripts time
+// the same on any display; a slow frame catches up with extra ticks, up to
+// maxTicksPerFrame, and time beyond that is dropped (the project slows down
+// instead of spiralling). alpha() says how far the next tick is, for
+// drawing between the last two.
+class FixedStep {
+public:
+  struct Config {
+    int ticksPerSecond = 30;  // Scratch's rate
+    int maxTicksPerFrame = 4; // catch-up limit
+  };
+  Config& config() { return config_; }
+  const Config& config() const { return config_; }
+
+  // ticks to run for a frame that took `frameSeconds`
+  int advance(double frameSeconds);
+  void reset();
+
+  double tickSeconds() const;
+  float alpha() const;
+  uint64_t droppedTicks() const { return dropped_; } // lost to the catch-up limit
+
+private:
+  Config config_{};
+  double accumulator_{0.0};
+  uint64_t dropped_{0};
+};
@@ -0,0 +1,31 @@
+#include "runtime/Governor.h"
+
+#include <algorithm>
+
+void Governor::reset() {
+  nsPerStep_ = 0.0;
+  avgMillis_ = 0.0;
+  scale_ = 1.0;
+}
+
+void Governor::record(int steps, double millis, double targetMillis) {
+  if (steps > 0) {
+    const double ns = millis * 1.0e6 / steps;
+    nsPerStep_ = nsPerStep_ > 0.0 ? nsPerStep_ + kAlpha * (ns - nsPerStep_) : ns;
+  }
+  avgMillis_ += kAlpha * (millis - avgMillis_);
+
+  // back off quickly while over target, recover slowly
+  if (avgMillis_ > targetMillis) scale_ = std::max(kMinScale, scale_ * 0.85);
+  else scale_ = std::min(1.0, scale_ + 0.02);
+}
+
+int Governor::totalBudget(int cap, double targetMillis) const {
+  double steps = cap;
+  if (nsPerStep_ > 0.0) steps = std::min(steps, targetMillis * 1.0e6 / nsPerStep_);
+  return std::clamp((int)(steps * scale_), std::min(cap, kMinTotalSteps), cap);
+}
+
+int Governor::runnerBudget(int cap) const {
+  return std::clamp((int)(cap * scale_), 1, cap);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// Sizes each tick's script work to what the machine can do in a frame.
+//
+// Runtime reports every tick's steps and duration. The governor keeps a
+// rolling average of the cost of a step and of the tick time, and from them
+// the step budgets for the next tick: as many steps as fit the target tick
+// time at the measured cost, scaled down further while the average tick is
+// over target and eased back up once it is under. Work that doesn't fit
+// waits for the next tick (see Runtime's fair scheduling) rather than
+// pausing the project.
+class Governor {
+public:
+  void reset();
+
+  void record(int steps, double millis, double targetMillis);
+
+  // budgets for the next tick; never above the configured caps
+  int totalBudget(int cap, double targetMillis) const;
+  int runnerBudget(int cap) const;
+
+  double avgTickMillis() const { return avgMillis_; }
+  double nsPerStep() const { return nsPerStep_; }
+  double scale() const { return scale_; } // 1: not throttled
+
+private:
+  static constexpr double kAlpha = 0.1;     // weight of the newest tick
+  static constexpr double kMinScale = 0.05;
+  static constexpr int kMinTotalSteps = 64; // always let something run
+
+  double nsPerStep_{0.0}; // 0: not measured yet
+  double avgMillis_{0.0};
+  double scale_{1.0};
+};
@@ -0,0 +1,307 @@
+#include "runtime/InputLog.h"
+
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#include "core/FileUtil.h"
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'C', 'R', 'I'};
+constexpr uint8_t kVersion = 1;
+
+void putU8(std::string& out, uint8_t v) { out += (char)v; }
+
+void putLE(std::string& out, uint64_t v, int bytes) {
+  for (int i = 0; i < bytes; ++i) out += (char)((v >> (8 * i)) & 0xFF);
+}
+
+void putF32(std::string& out, float f) {
+  uint32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  putLE(out, bits, 4);
+}
+
+void putVarint(std::string& out, uint64_t v) {
+  while (v >= 0x80) {
+    out += (char)((v & 0x7F) | 0x80);
+    v >>= 7;
+  }
+  out += (char)v;
+}
+
+// reads past the end fail once and stay failed
+struct Reader {
+  const std::string& in;
+  size_t pos{0};
+  bool ok{true};
+
+  bool need(size_t n) {
+    if (ok && in.size() - pos >= n) return true;
+    ok = false;
+    return false;
+  }
+  uint64_t le(int bytes) {
+    if (!need((size_t)bytes)) return 0;
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= (uint64_t)(uint8_t)in[pos++] << (8 * i);
+    return v;
+  }
+  float f32() {
+    const uint32_t bits = (uint32_t)le(4);
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+  }
+  uint64_t varint() {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (!need(1)) return 0;
+      const uint8_t b = (uint8_t)in[pos++];
+      v |= (uint64_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) return v;
+    }
+    ok = false;
+    return 0;
+  }
+};
+
+} // namespace
+
+bool InputLog::save(const std::string& path, std::string* err) const {
+  std::string out(kMagic, sizeof(kMagic));
+  putU8(out, kVersion);
+  putLE(out, seed, 8);
+  putF32(out, dt);
+  putLE(out, ticks, 4);
+  putVarint(out, events.size());
+
+  uint32_t tick = 0;
+  for (const InputEvent& e : events) {
+    putVarint(out, e.tick - tick);
+    tick = e.tick;
+    putU8(out, (uint8_t)e.kind);
+    switch (e.kind) {
+      case InputEvent::Kind::KeyDown:
+      case InputEvent::Kind::KeyUp:
+      case InputEvent::Kind::KeyPress:
+        putLE(out, e.key, 2);
+        break;
+      case InputEvent::Kind::MouseMove:
+        putF32(out, e.x);
+        putF32(out, e.y);
+        putU8(out, (uint8_t)e.key);
+        break;
+      case InputEvent::Kind::MouseButton:
+        putU8(out, (uint8_t)e.key);
+        break;
+      case InputEvent::Kind::Answer:
+        putVarint(out, e.text.size());
+        out += e.text;
+        break;
+    }
+  }
+
+  if (!FileUtil::writeAllText(path, out)) {
+    if (err) *err = "Failed to write file";
+    return false;
+  }
+  return true;
+}
+
+bool InputLog::load(const std::string& path, std::string* err) {
+  std::string in;
+  if (!FileUtil::readAllText(path, in)) {
+    if (err) *err = "Failed to read file";
+    return false;
+  }
+  if (in.size() < sizeof(kMagic) + 1 || std::memcmp(in.data(), kMagic, sizeof(kMagic)) != 0 ||
+      (uint8_t)in[sizeof(kMagic)] != kVersion) {
+    if (err) *err = "Not an input recording (or a newer version)";
+    return false;
+  }
+
+  Reader r{in, sizeof(kMagic) + 1};
+  InputLog log;
+  log.seed = r.le(8);
+  log.dt = r.f32();
+  log.ticks = (uint32_t)r.le(4);
+  const uint64_t count = r.varint();
+  if (r.ok && count <= in.size()) log.events.reserve((size_t)count); // every event takes 2+ bytes
+
+  uint32_t tick = 0;
+  for (uint64_t i = 0; i < count && r.ok; ++i) {
+    InputEvent e;
+    tick += (uint32_t)r.varint();
+    e.tick = tick;
+    const uint8_t kind = (uint8_t)r.le(1);
+    e.kind = (InputEvent::Kind)kind;
+    switch (e.kind) {
+      case InputEvent::Kind::KeyDown:
+      case InputEvent::Kind::KeyUp:
+      case InputEvent::Kind::KeyPress:
+        e.key = (uint16_t)r.le(2);
+        if (e.key >= SDL_NUM_SCANCODES) r.ok = false;
+        break;
+      case InputEvent::Kind::MouseMove:
+        e.x = r.f32();
+        e.y = r.f32();
+        e.key = (uint16_t)r.le(1);
+        break;
+      case InputEvent::Kind::MouseButton:
+        e.key = (uint16_t)r.le(1);
+        break;
+      case InputEvent::Kind::Answer: {
+        const uint64_t len = r.varint();
+        if (r.need((size_t)len)) {
+          e.text = in.substr(r.pos, (size_t)len);
+          r.pos += (size_t)len;
+        }
+        break;
+      }
+      default:
+        r.ok = false;
+        break;
+    }
+    log.events.push_back(std::move(e));
+  }
+
+  if (!r.ok || !(log.dt > 0.0f)) {
+    if (err) *err = "Truncated or corrupt input recording";
+    return false;
+  }
+  *this = std::move(log);
+  return true;
+}
+
+void InputRecorder::begin(const Project& project, uint64_t seed) {
+  log_ = InputLog{};
+  log_.seed = seed;
+  presses_.clear();
+  // start from "nothing held": the first tick records what is
+  keys_ = {};
+  mouseX_ = mouseY_ = 0.0f;
+  mouseValid_ = false;
+  mouseDown_ = false;
+  answers_ = project.answerRevision();
+  active_ = true;
+}
+
+void InputRecorder::keyPressed(SDL_Scancode key) {
+  if (active_) presses_.push_back(key);
+}
+
+void InputRecorder::tick(const Project& project, float dt) {
+  if (!active_) return;
+  if (log_.ticks == 0) log_.dt = dt;
+  const uint32_t t = log_.ticks++;
+  const InputSnapshot& in = project.input();
+
+  auto add = [&](InputEvent::Kind kind, uint16_t key) {
+    InputEvent e;
+    e.tick = t;
+    e.kind = kind;
+    e.key = key;
+    log_.events.push_back(std::move(e));
+  };
+
+  // every change in order, so a tap between two ticks replays as one
+  for (const InputSnapshot::Edge& edge : in.edges) {
+    if (edge.key == InputSnapshot::kMouseButton) {
+      mouseDown_ = edge.down;
+      add(InputEvent::Kind::MouseButton, edge.down ? 1 : 0);
+    } else {
+      InputSnapshot::set(keys_, edge.key, edge.down);
+      add(edge.down ? InputEvent::Kind::KeyDown : InputEvent::Kind::KeyUp, edge.key);
+    }
+  }
+  // then whatever that leaves out: held before recording, dropped edges
+  for (size_t w = 0; w < keys_.size(); ++w) {
+    for (uint64_t diff = keys_[w] ^ in.held[w]; diff; diff &= diff - 1) {
+      const size_t k = w * 64 + (size_t)std::countr_zero(diff);
+      const bool down = InputSnapshot::test(in.held, k);
+      InputSnapshot::set(keys_, k, down);
+      add(down ? InputEvent::Kind::KeyDown : InputEvent::Kind::KeyUp, (uint16_t)k);
+    }
+  }
+  if (in.mouseHeld != mouseDown_) {
+    mouseDown_ = in.mouseHeld;
+    add(InputEvent::Kind::MouseButton, mouseDown_ ? 1 : 0);
+  }
+
+  if (in.mouseValid != mouseValid_ || (in.mouseValid && (in.mouseX != mouseX_ || in.mouseY != mouseY_))) {
+    mouseValid_ = in.mouseValid;
+    mouseX_ = in.mouseX;
+    mouseY_ = in.mouseY;
+    InputEvent e;
+    e.tick = t;
+    e.kind = InputEvent::Kind::MouseMove;
+    e.x = mouseX_;
+    e.y = mouseY_;
+    e.key = mouseValid_ ? 1 : 0;
+    log_.events.push_back(std::move(e));
+  }
+
+  for (SDL_Scancode key : presses_) add(InputEvent::Kind::KeyPress, (uint16_t)key);
+  presses_.clear();
+
+  if (project.answerRevision() != answers_) {
+    answers_ = project.answerRevision();
+    InputEvent e;
+    e.tick = t;
+    e.kind = InputEvent::Kind::Answer;
+    e.text = project.answer();
+    log_.events.push_back(std::move(e));
+  }
+}
+
+void InputPlayer::begin(InputLog log) {
+  log_ = std::move(log);
+  next_ = 0;
+  tick_ = 0;
+  keys_ = {};
+  mouseX_ = mouseY_ = 0.0f;
+  mouseValid_ = false;
+  mouseDown_ = false;
+  active_ = true;
+}
+
+bool InputPlayer::tick(Project& project, std::vector<SDL_Scancode>& presses) {
+  presses.clear();
+  if (!active_ || tick_ >= log_.ticks) {
+    active_ = false;
+    return false;
+  }
+
+  // live input since the last tick is dropped; the log's goes in, in order,
+  // so the snapshot gets the same edges the recording did
+  project.resetInput(keys_, mouseDown_);
+  bool answered = false;
+  std::string answer;
+  for (; next_ < log_.events.size() && log_.events[next_].tick == tick_; ++next_) {
+    const InputEvent& e = log_.events[next_];
+    switch (e.kind) {
+      case InputEvent::Kind::KeyDown:
+      case InputEvent::Kind::KeyUp:
+        InputSnapshot::set(keys_, e.key, e.kind == InputEvent::Kind::KeyDown);
+        project.setKeyDown((SDL_Scancode)e.key, e.kind == InputEvent::Kind::KeyDown);
+        break;
+      case InputEvent::Kind::KeyPress:    presses.push_back((SDL_Scancode)e.key); break;
+      case InputEvent::Kind::MouseMove:   mouseX_ = e.x; mouseY_ = e.y; mouseValid_ = e.key != 0; break;
+      case InputEvent::Kind::MouseButton:
+        mouseDown_ = e.key != 0;
+        project.setMouseButtonDown(mouseDown_);
+        break;
+      case InputEvent::Kind::Answer:      answered = true; answer = e.text; break;
+    }
+  }
+  ++tick_;
+
+  project.setMouseWorld(mouseX_, mouseY_, mouseValid_);
+  if (answered) {
+    project.setAskDraft(std::move(answer));
+    project.submitAskAnswer();
+  }
+  return true;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+
+#include "core/Project.h"
+
+// One run's input, tick by tick, so an interactive project can be replayed
+// (and profiled) unattended. Only changes are kept: keys going down or up,
+// key hats firing, the mouse moving or clicking and ask answers, each
+// stamped with the tick it came before.
+struct InputEvent {
+  enum class Kind : uint8_t { KeyDown, KeyUp, KeyPress, MouseMove, MouseButton, Answer };
+
+  uint32_t tick{0};
+  Kind kind{Kind::KeyDown};
+  uint16_t key{0};        // Key*: scancode; MouseMove: 1 on stage; MouseButton: 1 down
+  float x{0.0f}, y{0.0f}; // MouseMove
+  std::string text;       // Answer
+};
+
+struct InputLog {
+  uint64_t seed{0};  // the run's random seed
+  float dt{0.0f};    // tick length
+  uint32_t ticks{0}; // ticks recorded
+  std::vector<InputEvent> events; // in tick order
+
+  // compact binary file (varint tick gaps)
+  bool save(const std::string& path, std::string* err = nullptr) const;
+  bool load(const std::string& path, std::string* err = nullptr);
+};
+
+// Builds a log from the project's input snapshot, taken once before each tick
+class InputRecorder {
+public:
+  void begin(const Project& project, uint64_t seed);
+  void end() { active_ = false; }
+  bool active() const { return active_; }
+
+  void keyPressed(SDL_Scancode key); // a key hat fired before the next tick
+  void tick(const Project& project, float dt);
+
+  const InputLog& log() const { return log_; }
+
+private:
+  bool active_{false};
+  InputLog log_;
+  std::vector<SDL_Scancode> presses_; // since the last tick
+  InputSnapshot::KeyBits keys_{}; // held, as logged so far
+  float mouseX_{0.0f}, mouseY_{0.0f};
+  bool mouseValid_{false};
+  bool mouseDown_{false};
+  uint64_t answers_{0}; // Project::answerRevision() last seen
+};
+
+// Puts a log's input back onto the project at the ticks it was recorded
+class InputPlayer {
+public:
+  void begin(InputLog log);
+  void end() { active_ = false; }
+  bool active() const { return active_; }
+  const InputLog& log() const { return log_; }
+
+  // before each tick's snapshot: the recorded input in place of the live
+  // one, and the keys whose hats fired before it; false once the log has
+  // run out
+  bool tick(Project& project, std::vector<SDL_Scancode>& presses);
+
+private:
+  bool active_{false};
+  InputLog log_;
+  size_t next_{0};
+  uint32_t tick_{0};
+  InputSnapshot::KeyBits keys_{};
+  float mouseX_{0.0f}, mouseY_{0.0f};
+  bool mouseValid_{false};
+  bool mouseDown_{false};
+};
@@ -0,0 +1,51 @@
+#include "runtime/Messages.h"
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Table {
+  std::unordered_map<std::string, int> ids;
+  std::vector<std::string> names;
+};
+
+Table& table() {
+  static Table t;
+  return t;
+}
+
+std::string normalize(const std::string& s) {
+  auto notSpace = [](unsigned char c) { return !std::isspace(c); };
+  auto b = std::find_if(s.begin(), s.end(), notSpace);
+  auto e = std::find_if(s.rbegin(), s.rend(), notSpace).base();
+  std::string out = (b < e) ? std::string(b, e) : std::string();
+  for (char& c : out) c = (char)std::tolower((unsigned char)c);
+  return out;
+}
+
+} // namespace
+
+namespace Messages {
+
+int intern(const std::string& name) {
+  Table& t = table();
+  std::string key = normalize(name);
+  auto it = t.ids.find(key);
+  if (it != t.ids.end()) return it->second;
+
+  int id = (int)t.names.size();
+  t.names.push_back(key);
+  t.ids.emplace(std::move(key), id);
+  return id;
+}
+
+const std::string& name(int id) {
+  static const std::string kNone;
+  const Table& t = table();
+  return (id >= 0 && id < (int)t.names.size()) ? t.names[(size_t)id] : kNone;
+}
+
+} // namespace Messages
@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+
+// Broadcast message names interned to small ints, so broadcasts and receiver
+// tables compare ids instead of strings. Matching is case-insensitive and
+// ignores surrounding spaces, like Scratch. Ids are process-wide and never
+// reused. Interning happens at compile time, on the main thread.
+namespace Messages {
+  int intern(const std::string& name);
+  const std::string& name(int id); // as first interned (lowercased)
+}
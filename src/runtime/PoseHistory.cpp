@@ -0,0 +1,50 @@
+#include "runtime/PoseHistory.h"
+
+#include <cmath>
+
+namespace {
+
+PoseHistory::Pose lerp(const PoseHistory::Pose& a, float x, float y, float dir, float t) {
+  // turn the short way round: 170 -> -170 passes through 180, not 0
+  float turn = std::fmod(dir - a.directionDeg + 540.0f, 360.0f) - 180.0f;
+  return {a.x + (x - a.x) * t, a.y + (y - a.y) * t, a.directionDeg + turn * t};
+}
+
+} // namespace
+
+void PoseHistory::capture(const Project& project) {
+  const auto& sprites = project.sprites();
+  sprites_.resize(sprites.size());
+  spriteIds_.resize(sprites.size());
+  for (size_t i = 0; i < sprites.size(); ++i) {
+    sprites_[i] = {sprites[i].x, sprites[i].y, sprites[i].directionDeg};
+    spriteIds_[i] = sprites[i].id;
+  }
+
+  const CloneStore& clones = project.clones();
+  clones_.resize(clones.capacity());
+  cloneGen_.assign(clones.capacity(), kNone);
+  for (uint32_t s : clones.live()) {
+    clones_[s] = {clones.x[s], clones.y[s], clones.directionDeg[s]};
+    cloneGen_[s] = clones.handle(s).gen;
+  }
+}
+
+void PoseHistory::clear() {
+  sprites_.clear();
+  spriteIds_.clear();
+  clones_.clear();
+  cloneGen_.clear();
+}
+
+PoseHistory::Pose PoseHistory::sprite(size_t index, const Sprite& sp, float alpha) const {
+  if (index >= sprites_.size() || spriteIds_[index] != sp.id) return {sp.x, sp.y, sp.directionDeg};
+  return lerp(sprites_[index], sp.x, sp.y, sp.directionDeg, alpha);
+}
+
+PoseHistory::Pose PoseHistory::clone(const CloneStore& clones, uint32_t slot, float alpha) const {
+  if (slot >= cloneGen_.size() || cloneGen_[slot] != clones.handle(slot).gen) {
+    return {clones.x[slot], clones.y[slot], clones.directionDeg[slot]};
+  }
+  return lerp(clones_[slot], clones.x[slot], clones.y[slot], clones.directionDeg[slot], alpha);
+}
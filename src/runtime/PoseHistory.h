@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "core/Project.h"
+
+// Sprite and clone transforms as they were before the last tick, so the
+// stage can be drawn between two ticks instead of jumping from one to the
+// next. Sprites are matched by index and id, clones by slot and generation;
+// one that wasn't there at the capture is drawn where it is.
+class PoseHistory {
+public:
+  struct Pose {
+    float x{0.0f}, y{0.0f};
+    float directionDeg{90.0f};
+  };
+
+  void capture(const Project& project);
+  void clear();
+
+  // alpha 0: the captured pose, 1: the current one
+  Pose sprite(size_t index, const Sprite& sp, float alpha) const;
+  Pose clone(const CloneStore& clones, uint32_t slot, float alpha) const;
+
+private:
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  std::vector<Pose> sprites_;
+  std::vector<int> spriteIds_;
+  std::vector<Pose> clones_;       // by slot
+  std::vector<uint32_t> cloneGen_; // by slot, kNone: no clone there
+};
@@ -0,0 +1,120 @@
+#include "runtime/Profiler.h"
+
+#include <algorithm>
+
+ProfileSink::Cell* ProfileSink::cells(const std::shared_ptr<const Program>& program) {
+  if (program.get() != last_) {
+    Entry& e = programs_[program.get()];
+    if (!e.program) e.program = program;
+    if (e.cells.size() != program->code.size()) e.cells.assign(program->code.size(), Cell{});
+    last_ = program.get();
+    lastEntry_ = &e;
+  }
+  lastEntry_->touched = true;
+  return lastEntry_->cells.data();
+}
+
+void ProfileSink::clear() {
+  programs_.clear();
+  last_ = nullptr;
+  lastEntry_ = nullptr;
+}
+
+void Profiler::reset() {
+  blocks_.clear();
+  blockIndex_.clear();
+  scripts_.clear();
+  scriptIndex_.clear();
+  types_ = {};
+  totalNs_ = 0;
+  maxSelfNs_ = 0;
+}
+
+void Profiler::collect(ProfileSink& sink) {
+  for (auto& kv : sink.programs_) {
+    ProfileSink::Entry& e = kv.second;
+    if (!e.touched) continue;
+    e.touched = false;
+    fold(*e.program, e.cells);
+  }
+}
+
+void Profiler::fold(const Program& prog, std::vector<ProfileSink::Cell>& cells) {
+  auto sIt = scriptIndex_.try_emplace(prog.scriptId, scripts_.size()).first;
+  if (sIt->second == scripts_.size()) scripts_.push_back({prog.spriteId, prog.scriptId, 0, 0});
+  ScriptStats& script = scripts_[sIt->second];
+
+  auto statsOf = [&](const Instr& in) -> BlockStats& {
+    auto it = blockIndex_.try_emplace(in.blockId, blocks_.size()).first;
+    if (it->second == blocks_.size()) blocks_.push_back({in.blockId, prog.spriteId, prog.scriptId, in.type, 0, 0, 0});
+    return blocks_[it->second];
+  };
+
+  // self counts
+  const int n = (int)cells.size();
+  for (int pc = 0; pc < n; ++pc) {
+    const ProfileSink::Cell& c = cells[(size_t)pc];
+    const Instr& in = prog.code[(size_t)pc];
+    if (c.count == 0 || in.blockId < 0) continue;
+
+    BlockStats& b = statsOf(in);
+    b.count += c.count;
+    b.selfNs += c.ns;
+    b.totalNs += c.ns;
+    maxSelfNs_ = std::max(maxSelfNs_, b.selfNs);
+
+    TypeStats& t = types_[(size_t)in.type];
+    t.type = in.type;
+    t.count += c.count;
+    t.ns += c.ns;
+
+    script.count += c.count;
+    script.ns += c.ns;
+    totalNs_ += c.ns;
+  }
+
+  // control blocks also get the time of the code they span: from a back-edge
+  // up to its target, or from a forward jump up to where it lands
+  struct Span {
+    int pc; // the block's first instruction
+    int lo, hi;
+  };
+  std::vector<Span> spans;
+  for (int pc = 0; pc < n; ++pc) {
+    const Instr& in = prog.code[(size_t)pc];
+    if (in.op == OpCode::Exec || in.op == OpCode::End || in.blockId < 0) continue;
+    int lo = pc, hi = pc;
+    if (in.target >= 0 && in.target < pc) lo = in.target;
+    if (in.target > pc) hi = in.target - 1;
+    auto it = std::find_if(spans.begin(), spans.end(),
+                           [&](const Span& s) { return prog.code[(size_t)s.pc].blockId == in.blockId; });
+    if (it == spans.end()) {
+      spans.push_back({pc, lo, hi});
+    } else {
+      it->lo = std::min(it->lo, lo);
+      it->hi = std::max(it->hi, hi);
+    }
+  }
+  for (const Span& s : spans) {
+    const Instr& in = prog.code[(size_t)s.pc];
+    uint64_t inside = 0;
+    for (int pc = s.lo; pc <= s.hi && pc < n; ++pc) {
+      if (prog.code[(size_t)pc].blockId != in.blockId) inside += cells[(size_t)pc].ns;
+    }
+    if (inside > 0) statsOf(in).totalNs += inside;
+  }
+
+  std::fill(cells.begin(), cells.end(), ProfileSink::Cell{});
+}
+
+void Profiler::types(std::vector<TypeStats>& out) const {
+  out.clear();
+  for (const TypeStats& t : types_) {
+    if (t.count > 0) out.push_back(t);
+  }
+}
+
+const Profiler::BlockStats* Profiler::block(int blockId) const {
+  auto it = blockIndex_.find(blockId);
+  return it == blockIndex_.end() ? nullptr : &blocks_[it->second];
+}
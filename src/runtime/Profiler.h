@@ -0,0 +1,106 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "model/Block.h"
+#include "runtime/Compiler.h"
+
+// Raw counts from one thread's runners: per program, per pc. A runner with
+// RunContext::profile set counts every instruction it visits and times one
+// step in kSampleEvery on average; Profiler folds the counts in after each
+// tick. The gaps between timed steps are random so a loop whose length
+// divides the period can't hide its blocks from the samples.
+class ProfileSink {
+public:
+  static constexpr uint32_t kSampleEvery = 32;
+
+  struct Cell {
+    uint64_t count{0};
+    uint64_t ns{0}; // sampled, already scaled by kSampleEvery
+  };
+
+  // cells for every pc of `program`; valid until the next cells() or clear()
+  Cell* cells(const std::shared_ptr<const Program>& program);
+  bool sampleNext() {
+    if (--untilSample_ > 0) return false;
+    rng_ ^= rng_ << 13; // xorshift32
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    untilSample_ = 1 + rng_ % (2 * kSampleEvery - 1); // mean kSampleEvery
+    return true;
+  }
+
+  void clear(); // drop the programs too (they may be freed after a stop)
+
+private:
+  friend class Profiler;
+  struct Entry {
+    std::shared_ptr<const Program> program; // kept alive until folded
+    std::vector<Cell> cells;
+    bool touched{false};
+  };
+  std::unordered_map<const Program*, Entry> programs_;
+  const Program* last_{nullptr};
+  Entry* lastEntry_{nullptr};
+  uint32_t untilSample_{kSampleEvery};
+  uint32_t rng_{0x9E3779B9u};
+};
+
+// Where the interpreter spends its time, since the last reset: execution
+// counts and sampled time per block, per block type and per script. Loops
+// and ifs also get the time of the blocks inside them (totalNs), so the loop
+// that eats the frame stands out.
+class Profiler {
+public:
+  struct BlockStats {
+    int blockId{-1};
+    int spriteId{0};
+    int scriptId{0};
+    BlockType type{BlockType::MoveSteps};
+    uint64_t count{0};   // times run; loops count once per iteration
+    uint64_t selfNs{0};
+    uint64_t totalNs{0}; // with the blocks inside (control blocks)
+  };
+  struct TypeStats {
+    BlockType type{BlockType::MoveSteps};
+    uint64_t count{0};
+    uint64_t ns{0};
+  };
+  struct ScriptStats {
+    int spriteId{0};
+    int scriptId{0};
+    uint64_t count{0};
+    uint64_t ns{0};
+  };
+
+  void setEnabled(bool on) { enabled_ = on; }
+  bool enabled() const { return enabled_; }
+
+  void reset();
+  void collect(ProfileSink& sink); // fold its counts in and zero them
+
+  const std::vector<BlockStats>& blocks() const { return blocks_; }
+  const std::vector<ScriptStats>& scripts() const { return scripts_; }
+  void types(std::vector<TypeStats>& out) const; // the ones that ran
+
+  const BlockStats* block(int blockId) const; // null: never ran
+  uint64_t totalNs() const { return totalNs_; }
+  uint64_t maxSelfNs() const { return maxSelfNs_; } // for heatmap scaling
+
+private:
+  static constexpr size_t kTypes = (size_t)BlockType::DeleteThisClone + 1;
+
+  void fold(const Program& prog, std::vector<ProfileSink::Cell>& cells);
+
+  bool enabled_{false};
+  std::vector<BlockStats> blocks_;
+  std::unordered_map<int, size_t> blockIndex_; // block id -> blocks_
+  std::vector<ScriptStats> scripts_;
+  std::unordered_map<int, size_t> scriptIndex_; // script id -> scripts_
+  std::array<TypeStats, kTypes> types_{};
+  uint64_t totalNs_{0};
+  uint64_t maxSelfNs_{0};
+};
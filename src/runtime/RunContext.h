@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "model/CloneStore.h"
+
+class AudioSink;
+class ProfileSink;
+class SensingIndex;
+struct Sound;
+
+// broadcast-and-wait: receivers started by one broadcast that haven't
+// finished yet. Starts at 1 ("not dispatched") so the waiter blocks until
+// Runtime has started them.
+struct BroadcastWait {
+  int pending{1};
+};
+
+struct BroadcastRequest {
+  int message{-1};                    // Messages id
+  std::shared_ptr<BroadcastWait> wait; // null for a plain broadcast
+};
+
+// Something a runner did to state outside its own sprite during a parallel
+// pass; Runtime applies it once the pass is over.
+struct GlobalEffect {
+  enum class Kind : uint8_t { StopAll, Ask, PlaySound, StopAllSounds, CreateClone, DeleteClone };
+  Kind kind{Kind::StopAll};
+  uint32_t runner{0};                 // index in Runtime's runners (set by Runtime)
+
+  const std::string* prompt{nullptr}; // Ask, points into the Program
+
+  const Sound* sound{nullptr};        // PlaySound
+  float volume{0.0f};
+  float pitch{0.0f};
+  bool untilDone{false};              // the runner sleeps for the sound's length
+
+  int target{0};                      // CreateClone of another sprite; 0: copy `clone`
+  CloneStore::State clone{};
+  CloneHandle handle{};               // DeleteClone
+};
+
+// Services shared by every runner of a Runtime; owned by Runtime and handed
+// to ScriptRunner::start. Members may be null (e.g. a bare runner in a
+// benchmark), in which case the runner falls back to the slow path.
+struct RunContext {
+  AudioSink* audio{nullptr};
+  SensingIndex* sensing{nullptr};
+
+  // queued by runners, handled by Runtime after the current pass
+  std::vector<BroadcastRequest> broadcasts;
+  std::vector<CloneHandle> clonesStarted; // "when I start as a clone" to run
+  bool cloneDeleted{false};               // parked runners of it must stop
+
+  // parallel pass: shared state (stop all, ask, audio, the clone pool) is
+  // left alone and runners queue effects here instead
+  bool deferGlobal{false};
+  std::vector<GlobalEffect> effects;
+
+  // profiling on: where runners count what they run (one sink per thread)
+  ProfileSink* profile{nullptr};
+};
@@ -4,7 +4,8 @@
 #include <chrono>
 
 #include "core/Logger.h"
-#include "audio/AudioEngine.h"
+#include "core/Trace.h"
+#include "runtime/Compiler.h"
 
 static int clampi(int v, int lo, int hi) {
   if (v < lo) return lo;
@@ -12,34 +13,202 @@ static int clampi(int v, int lo, int hi) {
   return v;
 }
 
+// std heap functions build a max-heap; invert to get the earliest wake first
+bool Runtime::wakesLater(const Sleeper& a, const Sleeper& b) {
+  if (a.wakeAt != b.wakeAt) return a.wakeAt > b.wakeAt;
+  return a.seq > b.seq;
+}
+
 void Runtime::pauseWithError(const std::string& msg) {
   lastError_ = msg;
   Logger::error("Runtime", msg);
   setPaused(true);
 }
 
+bool Runtime::startHat(Project& project, EventIndex::Hat& hat, std::shared_ptr<BroadcastWait> startedBy,
+                       CloneHandle clone) {
+  // compiled on first use and kept in programs_ for refreshEditedOperands.
+  // The index keeps programs over args edits, so this only recompiles after
+  // the scripts changed; the old program is replaced once no runner has it.
+  if (!hat.program) {
+    Sprite* sp = project.findSpriteById(hat.spriteId);
+    const Script* sc = sp ? project.findScript(*sp, hat.scriptId) : nullptr;
+    if (!sc) return false;
+    hat.program = Compiler::compileScript(project, *sp, *sc);
+    auto stale = std::find_if(programs_.begin(), programs_.end(), [&](const std::shared_ptr<Program>& p) {
+      return p->scriptId == hat.scriptId && p.use_count() == 1;
+    });
+    if (stale != programs_.end()) *stale = hat.program;
+    else programs_.push_back(hat.program);
+  }
+
+  ScriptRunner r;
+  r.seedRandom(runSeed_, runnerStarts_++);
+  r.start(project, hat.program, ctx_, clone);
+  if (r.isFinished()) return false;
+
+  r.setStartedBy(std::move(startedBy));
+  ++activeScripts_[r.scriptId()];
+  runners_.push_back(std::move(r));
+  return true;
+}
+
+// the same hat on every live clone of its sprite
+int Runtime::startHatOnClones(Project& project, EventIndex::Hat& hat, std::shared_ptr<BroadcastWait> startedBy) {
+  const CloneStore& clones = project.clones();
+  int started = 0;
+  for (uint32_t s : clones.live()) {
+    if (clones.parentId[s] != hat.spriteId) continue;
+    if (startHat(project, hat, startedBy, clones.handle(s))) ++started;
+  }
+  return started;
+}
+
+// A runner leaves the runtime: it no longer counts as running its script,
+// nor toward the broadcast-and-wait that started it.
+void Runtime::releaseRunner(ScriptRunner& r) {
+  auto it = activeScripts_.find(r.scriptId());
+  if (it != activeScripts_.end() && --it->second <= 0) activeScripts_.erase(it);
+
+  if (auto w = r.takeStartedBy()) {
+    if (--w->pending == 0) broadcastDone_ = true;
+  }
+}
+
+void Runtime::stopScript(int scriptId) {
+  auto it = activeScripts_.find(scriptId);
+  if (it == activeScripts_.end()) return;
+
+  // runnable ones are released by retireRunners()
+  for (auto& r : runners_) {
+    if (r.scriptId() == scriptId) r.stop();
+  }
+  stopParked([&](const ScriptRunner& r) { return r.scriptId() == scriptId; });
+}
+
+template <class Pred>
+void Runtime::stopParked(Pred pred) {
+  auto parked = [&](ScriptRunner& r) {
+    if (!pred(r)) return false;
+    r.stop();
+    releaseRunner(r);
+    return true;
+  };
+  size_t sleepers = sleeping_.size();
+  sleeping_.erase(std::remove_if(sleeping_.begin(), sleeping_.end(),
+                                 [&](Sleeper& s) { return parked(s.runner); }),
+                  sleeping_.end());
+  if (sleeping_.size() != sleepers) std::make_heap(sleeping_.begin(), sleeping_.end(), wakesLater);
+  waiting_.erase(std::remove_if(waiting_.begin(), waiting_.end(), parked), waiting_.end());
+}
+
+// Start the receivers of everything broadcast during the last pass. Like
+// Scratch, a receiver that is still running restarts.
+bool Runtime::dispatchBroadcasts(Project& project) {
+  if (ctx_.broadcasts.empty()) return false;
+  events_.sync(project);
+
+  std::vector<BroadcastRequest> requests;
+  requests.swap(ctx_.broadcasts);
+
+  bool started = false;
+  for (auto& req : requests) {
+    int count = 0;
+    for (auto& hat : events_.received(req.message)) {
+      stopScript(hat.scriptId);
+      if (startHat(project, hat, req.wait)) ++count;
+      count += startHatOnClones(project, hat, req.wait);
+    }
+    if (req.wait) {
+      req.wait->pending = count;
+      if (count == 0) broadcastDone_ = true;
+    }
+    started |= count > 0;
+  }
+
+  // an empty queue keeps its capacity for the next pass
+  requests.clear();
+  if (ctx_.broadcasts.empty()) ctx_.broadcasts.swap(requests);
+  return started;
+}
+
+// "when I start as a clone" for clones made during the last pass; runners
+// of deleted clones that are parked (and so not stepping) stop here
+bool Runtime::dispatchClones(Project& project) {
+  CloneStore& clones = project.clones();
+  if (ctx_.cloneDeleted) {
+    ctx_.cloneDeleted = false;
+    stopParked([&](const ScriptRunner& r) { return r.clone().valid() && !clones.alive(r.clone()); });
+  }
+  if (ctx_.clonesStarted.empty()) return false;
+  events_.sync(project);
+
+  bool started = false;
+  for (CloneHandle h : ctx_.clonesStarted) {
+    if (!clones.alive(h)) continue; // deleted again in the same pass
+    for (auto& hat : events_.cloneStarted(clones.parentId[h.slot])) started |= startHat(project, hat, nullptr, h);
+  }
+  ctx_.clonesStarted.clear();
+  return started;
+}
+
+void Runtime::wakeBroadcastWaiters() {
+  if (!broadcastDone_) return;
+  broadcastDone_ = false;
+
+  size_t keep = 0;
+  for (size_t i = 0; i < waiting_.size(); ++i) {
+    if (!waiting_[i].isAwaitingBroadcast()) {
+      runners_.push_back(std::move(waiting_[i]));
+      continue;
+    }
+    if (keep != i) waiting_[keep] = std::move(waiting_[i]);
+    ++keep;
+  }
+  waiting_.resize(keep);
+}
+
 void Runtime::startGreenFlag(Project& project) {
   // Scratch-like: starting green flag stops any playing sounds.
-  AudioEngine::instance().stopAll();
+  audioSink().stopAll();
+  finishInputRecording();
+  player_.end();
 
   runners_.clear();
+  sleeping_.clear();
+  waiting_.clear();
+  ctx_.broadcasts.clear();
+  ctx_.clonesStarted.clear();
+  activeScripts_.clear();
+  clones_ = &project.clones();
+  clones_->clear();
+  clock_ = 0.0;
+  totalSteps_ = 0;
+  governor_.reset();
+  watchdog_.clear();
+  if (profiler_.enabled()) collectProfile(true);
+  programs_.clear();
+  argsRevision_ = project.argsRevision();
   lastError_.clear();
+  if (replayNext_) {
+    player_.begin(std::move(replayLog_));
+    replayNext_ = false;
+  }
+  seedRun(project);
+  if (!recordNext_.empty()) {
+    recorder_.begin(project, runSeed_);
+    recordPath_ = std::move(recordNext_);
+    recordNext_.clear();
+  }
 
   running_ = true;
   paused_ = false;
+  project.snapshotInput(); // edges from before the run don't count as this tick's
+  sensing_.rebuild(project);
+  events_.clear(); // every hat compiles fresh for this run
+  events_.sync(project);
 
-  for (auto& sp : project.sprites()) {
-    for (auto& sc : sp.scripts) {
-      if (sc.headBlockId == -1) continue;
-
-      auto it = sp.blocks.find(sc.headBlockId);
-      if (it == sp.blocks.end()) continue;
-
-      ScriptRunner r;
-      r.start(project, sp.id, sc.id);
-      if (!r.isFinished()) runners_.push_back(std::move(r));
-    }
-  }
+  for (auto& hat : events_.greenFlag()) startHat(project, hat);
 
   Logger::info("Runtime", "Green flag: started " + std::to_string((int)runners_.size()) + " runner(s)");
 
@@ -47,86 +216,691 @@ void Runtime::startGreenFlag(Project& project) {
     Logger::warn("Runtime", "No runnable scripts found (headBlockId missing or invalid).");
     running_ = false;
     paused_ = false;
+    finishInputRecording();
+    player_.end();
+  }
+}
+
+void Runtime::keyPressed(Project& project, SDL_Scancode key) {
+  if (paused_) return;
+  if (player_.active()) return; // a replay presses the recorded keys
+  startKeyHats(project, key);
+}
+
+void Runtime::startKeyHats(Project& project, SDL_Scancode key) {
+  events_.sync(project);
+
+  auto& byKey = events_.keyPressed(key);
+  auto& anyKey = events_.anyKeyPressed();
+  if (byKey.empty() && anyKey.empty()) return;
+  recorder_.keyPressed(key);
+
+  if (!running_) {
+    // first scripts since the last stop: start from a clean slate
+    runners_.clear();
+    sleeping_.clear();
+    waiting_.clear();
+    ctx_.broadcasts.clear();
+    ctx_.clonesStarted.clear();
+    activeScripts_.clear();
+    clock_ = 0.0;
+    argsRevision_ = project.argsRevision();
+    seedRun(project);
+    sensing_.rebuild(project);
+  }
+
+  int started = 0;
+  for (auto* hats : {&byKey, &anyKey}) {
+    for (auto& hat : *hats) {
+      auto it = activeScripts_.find(hat.scriptId);
+      if (it != activeScripts_.end() && it->second > 0) continue;
+      if (startHat(project, hat)) ++started;
+      started += startHatOnClones(project, hat);
+    }
+  }
+  if (started > 0) {
+    running_ = true;
+    clones_ = &project.clones();
+  }
+}
+
+void Runtime::seedRun(const Project& project) {
+  runSeed_ = player_.active() ? player_.log().seed : seedOverride_ ? seedOverride_ : project.randomSeed();
+  if (!runSeed_) runSeed_ = Random::mix((uint64_t)std::chrono::steady_clock::now().time_since_epoch().count());
+  runnerStarts_ = 0;
+  Logger::info("Runtime", "Random seed " + std::to_string(runSeed_));
+}
+
+void Runtime::refreshEditedOperands(Project& project) {
+  argsRevision_ = project.argsRevision();
+  for (auto& prog : programs_) {
+    if (Sprite* sp = project.findSpriteById(prog->spriteId)) Compiler::refreshOperands(*prog, project, *sp);
   }
 }
 
 void Runtime::stopAll() {
-  AudioEngine::instance().stopAll();
+  audioSink().stopAll();
   for (auto& r : runners_) r.stop();
   runners_.clear();
+  sleeping_.clear();
+  waiting_.clear();
+  ctx_.broadcasts.clear();
+  ctx_.clonesStarted.clear();
+  activeScripts_.clear();
+  if (profiler_.enabled()) collectProfile(true);
+  programs_.clear();
+  events_.clear();
+  if (clones_) clones_->clear(); // like Scratch, stop deletes every clone
   running_ = false;
   paused_ = false;
   lastError_.clear();
+  watchdog_.clear();
+  finishInputRecording();
+  player_.end();
   Logger::info("Runtime", "Stopped all");
 }
 
 void Runtime::setPaused(bool p) {
   paused_ = p;
   for (auto& r : runners_) r.setPaused(p);
+  for (auto& s : sleeping_) s.runner.setPaused(p);
+  for (auto& r : waiting_) r.setPaused(p);
+}
+
+void Runtime::setTurbo(bool t) {
+  if (turbo_ == t) return;
+  turbo_ = t;
+  Logger::info("Runtime", std::string("Turbo mode ") + (t ? "on" : "off"));
+}
+
+void Runtime::setParallel(bool p, unsigned threads) {
+  if (!threads) threads = WorkerPool::defaultThreads();
+  if (p && (!pool_ || pool_->threads() != threads)) pool_ = std::make_unique<WorkerPool>(threads);
+  if (!p) pool_.reset();
+  if (parallel_ == p) return;
+  parallel_ = p;
+  Logger::info("Runtime", p ? "Parallel mode on (" + std::to_string(threads + 1) + " threads)"
+                            : std::string("Parallel mode off"));
+}
+
+void Runtime::setProfiling(bool on) {
+  if (profiler_.enabled() == on) return;
+  if (!on) collectProfile(true);
+  profiler_.setEnabled(on);
+  ctx_.profile = on ? &profile_ : nullptr;
+  Logger::info("Runtime", std::string("Profiling ") + (on ? "on" : "off"));
+}
+
+void Runtime::collectProfile(bool release) {
+  profiler_.collect(profile_);
+  for (Group& g : groups_) profiler_.collect(g.profile);
+  if (!release) return;
+  profile_.clear();
+  for (Group& g : groups_) g.profile.clear();
+}
+
+// ask and wait: the first runner waiting gets the answer, as in a serial pass
+void Runtime::handOutAskAnswer(Project& project) {
+  for (auto& r : runners_) {
+    if (r.isFinished() || !r.isWaitingAsk()) continue;
+    if (project.consumeAskAnswered()) r.answerAsk();
+    return;
+  }
+}
+
+void Runtime::runGroup(Project& project, Group& g) {
+  g.ctx.profile = ctx_.profile ? &g.profile : nullptr; // groups_ may have moved since setup
+  for (uint32_t i : g.runners) {
+    ScriptRunner& r = runners_[i];
+    if (r.isFinished() || r.isSleeping()) continue;
+
+    const size_t firstEffect = g.ctx.effects.size();
+    int stepsDone = 0;
+    bool hadError = false;
+    std::string errMsg;
+
+    r.setContext(g.ctx);
+    r.tick(project, runnerBudget_, &stepsDone, &hadError, &errMsg);
+    r.setContext(ctx_);
+    g.steps += stepsDone;
+    if (!hadError && runaway(project, r, std::chrono::steady_clock::now(), &g.trip)) {
+      hadError = true;
+      g.tripped = true;
+      errMsg = g.trip.message;
+    }
+
+    for (size_t e = firstEffect; e < g.ctx.effects.size(); ++e) g.ctx.effects[e].runner = i;
+    if (hadError) {
+      g.error = errMsg.empty() ? "Runtime error (unknown)." : errMsg;
+      break;
+    }
+    if (!g.ctx.effects.empty() && g.ctx.effects.back().kind == GlobalEffect::Kind::StopAll) break;
+  }
+}
+
+bool Runtime::applyEffect(Project& project, const GlobalEffect& e) {
+  using Kind = GlobalEffect::Kind;
+  switch (e.kind) {
+    case Kind::StopAll:
+      stopAll();
+      return false;
+
+    case Kind::Ask:
+      project.beginAsk(*e.prompt);
+      break;
+
+    case Kind::PlaySound: {
+      auto pr = audioSink().playWav(e.sound->filePath, e.volume, e.pitch);
+      if (e.untilDone && pr.durationSec > 0.0f) runners_[e.runner].sleep(pr.durationSec);
+      break;
+    }
+
+    case Kind::StopAllSounds:
+      audioSink().stopAll();
+      break;
+
+    case Kind::CreateClone: {
+      CloneStore& clones = project.clones();
+      CloneHandle h;
+      if (e.target == 0) {
+        h = clones.spawn(e.clone);
+      } else if (const Sprite* target = project.findSpriteById(e.target)) {
+        h = clones.spawn(*target);
+      }
+      if (h.valid()) ctx_.clonesStarted.push_back(h);
+      break;
+    }
+
+    case Kind::DeleteClone:
+      project.clones().release(e.handle);
+      ctx_.cloneDeleted = true;
+      break;
+  }
+  return true;
+}
+
+// One pass in parallel mode: group, run the groups on the pool against a
+// frozen sensing snapshot, then apply what they queued in group order.
+bool Runtime::parallelPass(Project& project, int& totalSteps, bool& progressed) {
+  Trace::Scope trace("Runtime::parallelPass");
+  sched_ = SchedulerStats{}; // no global step budget here
+  project.refreshSpriteIndex(); // lookups from the workers must not rebuild it
+  sensing_.rebuild(project);    // the snapshot other sprites are sensed from
+  handOutAskAnswer(project);
+
+  // groups in order of their first runner; runner order kept within a group
+  const size_t bodies = project.sprites().size() + project.clones().capacity();
+  if (groupOfBody_.size() != bodies) groupOfBody_.assign(bodies, kNoGroup);
+  groupCount_ = 0;
+  for (uint32_t i = 0; i < (uint32_t)runners_.size(); ++i) {
+    ScriptRunner& r = runners_[i];
+    if (r.isFinished() || r.isSleeping()) continue;
+
+    size_t body;
+    if (r.clone().valid()) {
+      body = SensingIndex::cloneBody(project, r.clone().slot);
+    } else if (const Sprite* sp = project.findSpriteById(r.spriteId())) {
+      body = (size_t)(sp - project.sprites().data());
+    } else {
+      r.stop(); // its sprite is gone
+      continue;
+    }
+
+    if (groupOfBody_[body] == kNoGroup) {
+      if (groupCount_ == groups_.size()) groups_.emplace_back();
+      Group& g = groups_[groupCount_];
+      g.body = body;
+      g.runners.clear();
+      g.ctx.audio = &audioSink();
+      g.ctx.sensing = &sensing_;
+      g.ctx.deferGlobal = true;
+      g.ctx.broadcasts.clear();
+      g.ctx.effects.clear();
+      g.steps = 0;
+      g.error.clear();
+      g.tripped = false;
+      groupOfBody_[body] = (uint32_t)groupCount_++;
+    }
+    groups_[groupOfBody_[body]].runners.push_back(i);
+  }
+  for (size_t gi = 0; gi < groupCount_; ++gi) groupOfBody_[groups_[gi].body] = kNoGroup;
+
+  sensing_.freeze();
+  auto run = [&](size_t gi) { runGroup(project, groups_[gi]); };
+  if (pool_ && runners_.size() >= kMinParallelRunners) {
+    pool_->parallelFor(groupCount_, run);
+  } else {
+    for (size_t gi = 0; gi < groupCount_; ++gi) run(gi);
+  }
+  sensing_.thaw();
+
+  // commit
+  for (size_t gi = 0; gi < groupCount_; ++gi) {
+    Group& g = groups_[gi];
+    totalSteps += g.steps;
+    if (g.steps > 0) progressed = true;
+    for (auto& b : g.ctx.broadcasts) ctx_.broadcasts.push_back(std::move(b));
+    for (const auto& e : g.ctx.effects) {
+      if (!applyEffect(project, e)) return false;
+    }
+  }
+  for (size_t gi = 0; gi < groupCount_; ++gi) {
+    Group& g = groups_[gi];
+    if (g.error.empty()) continue;
+    if (g.tripped) pauseForWatchdog(std::move(g.trip));
+    else pauseWithError(g.error);
+    break;
+  }
+  return true;
+}
+
+// A runaway has run for the watchdog's time limit without yielding: every
+// slice since used its whole budget without a wait, the end of the script or
+// a loop end (warp scripts don't yield there; turbo ones do). The report
+// names the loop whose back-edge the runner took last, or the block it is on
+// if it never took one.
+bool Runtime::runaway(const Project& project, ScriptRunner& r, std::chrono::steady_clock::time_point now,
+                      Watchdog::Report* out) const {
+  if (r.unyieldedSteps() == 0) return false;
+  const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - r.unyieldedSince(now)).count();
+  if (!watchdog_.overLimit(ms)) return false;
+
+  const Program* prog = r.program();
+  const int pc = r.pc();
+  const int loopAt = prog && r.loopPc() < (int)prog->code.size() ? r.loopPc() : -1;
+
+  const Sprite* sp = project.findSpriteById(r.spriteId());
+  out->spriteId = r.spriteId();
+  out->scriptId = r.scriptId();
+  out->instructions = r.unyieldedSteps();
+  out->millis = (uint32_t)ms;
+  out->blockId = -1;
+  std::string where;
+  if (loopAt >= 0) {
+    const Instr& in = prog->code[(size_t)loopAt];
+    out->blockId = in.blockId;
+    where = std::string(" in its '") + blockLabel(in.type) + "' loop (block " + std::to_string(in.blockId) + ")";
+  } else if (prog && pc < (int)prog->code.size() && prog->code[(size_t)pc].blockId >= 0) {
+    out->blockId = prog->code[(size_t)pc].blockId;
+    where = std::string(" at '") + blockLabel(prog->code[(size_t)pc].type) + "' (block " +
+            std::to_string(out->blockId) + ")";
+  }
+  out->message = "Safety pause: script " + std::to_string(r.scriptId()) + " of '" +
+                 (sp ? sp->name : std::string("?")) + "' ran " + std::to_string(out->instructions) +
+                 " instructions in " + std::to_string(ms) + " ms without yielding" + where + ".";
+  return true;
+}
+
+void Runtime::pauseForWatchdog(Watchdog::Report report) {
+  lastError_ = report.message;
+  watchdog_.trip(std::move(report)); // logs it
+  setPaused(true);
+}
+
+void Runtime::stopTrippedScript() {
+  if (!watchdog_.tripped()) return;
+  stopScript(watchdog_.report().scriptId);
+  watchdog_.clear();
+  lastError_.clear();
+  setPaused(false);
+}
+
+void Runtime::keepTrippedScript() {
+  if (!watchdog_.tripped()) return;
+  const int scriptId = watchdog_.report().scriptId;
+  for (auto& r : runners_) {
+    if (r.scriptId() == scriptId) r.resetUnyielded();
+  }
+  watchdog_.clear();
+  lastError_.clear();
+  setPaused(false);
+}
+
+// One runner's slice of a serial pass; EndPass when the pass has to stop
+// early (error), OutOfTime when the tick's time is used up (never with fixed
+// budgets)
+Runtime::Slice Runtime::runSlice(Project& project, ScriptRunner& r, int budget, int* steps, int& totalSteps,
+                                 bool& progressed, std::chrono::steady_clock::time_point t0) {
+  bool hadError = false;
+  std::string errMsg;
+
+  r.tick(project, budget, steps, &hadError, &errMsg);
+  totalSteps += *steps;
+  if (*steps > 0) progressed = true;
+
+  if (project.consumeStopAllScriptsRequest()) {
+    stopAll();
+    return Slice::StoppedAll;
+  }
+
+  if (hadError) {
+    pauseWithError(errMsg.empty() ? "Runtime error (unknown)." : errMsg);
+    return Slice::EndPass;
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  Watchdog::Report trip;
+  if (runaway(project, r, t1, &trip)) {
+    pauseForWatchdog(std::move(trip));
+    return Slice::EndPass;
+  }
+
+  if (fixedBudgets_) return Slice::Ran;
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+  if (turbo_) {
+    if (ms >= safety_.turboTickMillis) { progressed = false; return Slice::EndPass; } // frame used up
+  } else if (ms > safety_.maxTickMillis) {
+    return Slice::OutOfTime;
+  }
+  return Slice::Ran;
+}
+
+// Normal mode shares the tick's step budget between the runners: each gets
+// at most an even share of what's left when its turn comes, and whatever
+// runners that needed less leave over goes round again to those that were
+// cut short. Runners the budget (or maxTickMillis) doesn't reach wait for
+// the next tick, which starts with them.
+bool Runtime::serialPass(Project& project, int& totalSteps, bool& progressed,
+                         std::chrono::steady_clock::time_point t0) {
+  Trace::Scope trace("Runtime::serialPass");
+  const size_t n = runners_.size();
+  const size_t start = (sched_.overloaded && n > 0) ? passStart_ % n : 0;
+  bool cutOff = false;
+  bool outOfTime = false;
+  capped_.clear();
+  sched_.runnable = 0;
+  sched_.starved = 0;
+  sched_.maxStarvedTicks = 0;
+
+  auto starve = [&](ScriptRunner& r, uint32_t i) {
+    if (!cutOff) passStart_ = i;
+    cutOff = true;
+    r.setStarved(true);
+    ++sched_.starved;
+    sched_.maxStarvedTicks = std::max(sched_.maxStarvedTicks, r.starvedTicks());
+  };
+
+  for (size_t k = 0; k < n; ++k) {
+    const uint32_t i = (uint32_t)((start + k) % n);
+    ScriptRunner& r = runners_[i];
+    if (r.isFinished() || r.isSleeping()) continue;
+    ++sched_.runnable;
+
+    int budget = runnerBudget_;
+    if (!turbo_) {
+      const int remaining = stepBudget_ - totalSteps;
+      if (remaining <= 0 || outOfTime) {
+        starve(r, i);
+        continue;
+      }
+      budget = std::min(budget, std::max(1, remaining / (int)(n - k)));
+    }
+
+    int steps = 0;
+    const Slice slice = runSlice(project, r, budget, &steps, totalSteps, progressed, t0);
+    if (slice == Slice::StoppedAll) return false;
+    r.setStarved(false);
+    if (slice == Slice::EndPass) return true;
+    if (slice == Slice::OutOfTime) outOfTime = true;
+
+    if (!turbo_ && steps == budget && budget < runnerBudget_ && !r.yielded() && !r.isFinished() &&
+        !r.isSleeping()) {
+      capped_.push_back({i, steps});
+    }
+  }
+
+  for (size_t k = 0; k < capped_.size() && !outOfTime; ++k) {
+    const int remaining = stepBudget_ - totalSteps;
+    if (remaining <= 0) break;
+    const int budget = std::min(runnerBudget_ - capped_[k].steps,
+                                std::max(1, remaining / (int)(capped_.size() - k)));
+    int steps = 0;
+    const Slice slice = runSlice(project, runners_[capped_[k].runner], budget, &steps, totalSteps, progressed, t0);
+    if (slice == Slice::StoppedAll) return false;
+    if (slice == Slice::EndPass) return true;
+    if (slice == Slice::OutOfTime) outOfTime = true;
+  }
+
+  sched_.overloaded = !turbo_ && (outOfTime || totalSteps >= stepBudget_);
+  if (sched_.overloaded && !cutOff && n > 0) passStart_ = (start + 1) % n; // everyone ran: just rotate
+  return true;
+}
+
+void Runtime::runnerInfo(std::vector<RunnerInfo>& out) const {
+  out.clear();
+  const size_t n = runners_.size();
+  const size_t start = (sched_.overloaded && n > 0) ? passStart_ % n : 0;
+  for (size_t k = 0; k < n; ++k) {
+    const ScriptRunner& r = runners_[(start + k) % n];
+    if (r.isFinished()) continue;
+    out.push_back({r.spriteId(), r.scriptId(), r.clone().valid(), r.starvedTicks()});
+  }
+}
+
+void Runtime::updateSayBubbles(Project& project, float dt) {
+  for (auto& sp : project.sprites()) {
+    if (sp.sayTimeRemaining <= 0.0f) continue;
+    sp.sayTimeRemaining -= dt;
+    if (sp.sayTimeRemaining <= 0.0f) {
+      sp.sayTimeRemaining = 0.0f;
+      sp.sayText.clear();
+    }
+  }
+
+  CloneStore& clones = project.clones();
+  for (uint32_t s : clones.live()) {
+    if (clones.sayTimeRemaining[s] <= 0.0f) continue;
+    clones.sayTimeRemaining[s] -= dt;
+    if (clones.sayTimeRemaining[s] <= 0.0f) {
+      clones.sayTimeRemaining[s] = 0.0f;
+      clones.sayText[s].clear();
+    }
+  }
+}
+
+void Runtime::wakeDueRunners() {
+  while (!sleeping_.empty() && sleeping_.front().wakeAt <= clock_) {
+    std::pop_heap(sleeping_.begin(), sleeping_.end(), wakesLater);
+    ScriptRunner r = std::move(sleeping_.back().runner);
+    sleeping_.pop_back();
+    r.wake();
+    runners_.push_back(std::move(r));
+  }
+}
+
+void Runtime::retireRunners() {
+  size_t keep = 0;
+  for (size_t i = 0; i < runners_.size(); ++i) {
+    ScriptRunner& r = runners_[i];
+    if (r.isFinished()) {
+      releaseRunner(r);
+      continue;
+    }
+
+    if (r.isAwaitingBroadcast()) {
+      waiting_.push_back(std::move(r));
+      continue;
+    }
+
+    if (r.isSleeping()) {
+      Sleeper s;
+      s.wakeAt = clock_ + r.sleepSeconds();
+      s.seq = sleepSeq_++;
+      s.runner = std::move(r);
+      sleeping_.push_back(std::move(s));
+      std::push_heap(sleeping_.begin(), sleeping_.end(), wakesLater);
+      continue;
+    }
+
+    if (keep != i) runners_[keep] = std::move(r);
+    ++keep;
+  }
+  runners_.resize(keep);
+
+  if (runners_.empty() && sleeping_.empty() && waiting_.empty()) {
+    running_ = false;
+    finishInputRecording();
+    player_.end();
+  }
 }
 
 void Runtime::tick(Project& project, float dt) {
   if (!running_) return;
   if (paused_) return;
+  clones_ = &project.clones();
+
+  // this tick's input: recorded input goes in first, and the snapshot is
+  // logged, before any script reads it
+  if (player_.active()) dt = replayTick(project, dt);
+  project.snapshotInput();
+  recorder_.tick(project, dt);
 
   if (project.consumeStopAllScriptsRequest()) {
     stopAll();
     return;
   }
 
+  // Inspector edits while running: pick up new argument values in place
+  if (project.argsRevision() != argsRevision_) refreshEditedOperands(project);
+
+  clock_ += dt;
+  updateSayBubbles(project, dt);
+  wakeDueRunners();
+  wakeBroadcastWaiters();
+  // picks up sprites moved in the editor; parallel passes rebuild their own
+  if (!parallel_) sensing_.rebuild(project);
+
   safety_.maxStepsPerRunnerPerTick = clampi(safety_.maxStepsPerRunnerPerTick, 1, 200000);
   safety_.maxTotalStepsPerTick     = clampi(safety_.maxTotalStepsPerTick,     1, 500000);
+  safety_.targetTickMillis         = clampi(safety_.targetTickMillis,         1, 1000);
   safety_.maxTickMillis            = clampi(safety_.maxTickMillis,            1, 1000);
+  safety_.turboTickMillis          = clampi(safety_.turboTickMillis,          1, 1000);
+
+  // turbo runs flat out for turboTickMillis; normal mode is governed. A
+  // recording or replay runs on the caps alone: what a tick does mustn't
+  // depend on how long earlier ones took.
+  fixedBudgets_ = recorder_.active() || player_.active();
+  const bool governed = !turbo_ && !fixedBudgets_;
+  stepBudget_ = governed ? governor_.totalBudget(safety_.maxTotalStepsPerTick, safety_.targetTickMillis)
+                         : safety_.maxTotalStepsPerTick;
+  runnerBudget_ = governed ? governor_.runnerBudget(safety_.maxStepsPerRunnerPerTick)
+                           : safety_.maxStepsPerRunnerPerTick;
 
   const auto t0 = std::chrono::steady_clock::now();
   int totalSteps = 0;
+  watchdog_.beginFrame();
+
+  // Normal mode: one pass, each runner runs until it yields (loop end,
+  // unmet WaitUntil, wait) or hits its budget. Turbo: repeat passes until
+  // the frame's time budget (with fixed budgets, the step budget) is spent
+  // or nothing can make progress.
+  for (bool progressed = true; progressed && !paused_;) {
+    progressed = false;
+
+    if (parallel_) {
+      if (!parallelPass(project, totalSteps, progressed)) return; // stop all
+
+      auto t1 = std::chrono::steady_clock::now();
+      auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+      if (turbo_ && !fixedBudgets_ && ms >= safety_.turboTickMillis) progressed = false; // frame used up
+    } else if (!serialPass(project, totalSteps, progressed, t0)) {
+      return; // stop all
+    }
+    if (turbo_ && fixedBudgets_ && totalSteps >= stepBudget_) progressed = false;
 
-  for (auto& r : runners_) {
-    if (r.isFinished()) continue;
+    // new clones and receivers start this tick and run in the next pass
+    // (turbo) or frame
+    if (!paused_ && dispatchClones(project)) progressed = true;
+    if (!paused_ && dispatchBroadcasts(project)) progressed = true;
 
-    int remaining = safety_.maxTotalStepsPerTick - totalSteps;
-    if (remaining <= 0) break;
+    if (!turbo_) break;
+  }
 
-    int perRunnerBudget = std::min(safety_.maxStepsPerRunnerPerTick, remaining);
+  totalSteps_ += (uint64_t)totalSteps;
+  watchdog_.addInstructions((uint32_t)totalSteps);
+  watchdog_.onFrameEnd();
+  if (!turbo_ && !fixedBudgets_) {
+    const std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - t0;
+    governor_.record(totalSteps, ms.count(), safety_.targetTickMillis);
+  }
+  if (profiler_.enabled()) collectProfile();
 
-    int stepsDone = 0;
-    bool hadError = false;
-    std::string errMsg;
+  retireRunners();
+}
 
-    r.tick(project, dt, perRunnerBudget, &stepsDone, &hadError, &errMsg);
-    totalSteps += stepsDone;
+void Runtime::recordInput(std::string path) {
+  recordNext_ = std::move(path);
+  Logger::info("Input", "Recording the next run's input to " + recordNext_);
+}
 
-    if (project.consumeStopAllScriptsRequest()) {
-      stopAll();
-      return;
-    }
+void Runtime::replayInput(InputLog log) {
+  replayLog_ = std::move(log);
+  replayNext_ = true;
+  Logger::info("Input", "Replaying " + std::to_string(replayLog_.ticks) + " tick(s) of input on the next run");
+}
 
-    if (hadError) {
-      pauseWithError(errMsg.empty() ? "Runtime error (unknown)." : errMsg);
-      break;
-    }
+void Runtime::finishInputRecording() {
+  if (!recorder_.active()) return;
+  recorder_.end();
+  const InputLog& log = recorder_.log();
+  std::string err;
+  if (log.save(recordPath_, &err)) {
+    Logger::info("Input", "Recorded " + std::to_string(log.ticks) + " tick(s), " + std::to_string(log.events.size()) +
+                              " event(s) to " + recordPath_);
+  } else {
+    Logger::error("Input", "Failed to write " + recordPath_ + ": " + err);
+  }
+  recordPath_.clear();
+}
 
-    auto t1 = std::chrono::steady_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
-    if (ms > safety_.maxTickMillis) {
-      pauseWithError("Safety pause: tick time budget exceeded (" + std::to_string((int)ms) + " ms).");
-      break;
-    }
+float Runtime::replayTick(Project& project, float dt) {
+  if (!player_.tick(project, replayPresses_)) {
+    Logger::info("Input", "Replay finished after " + std::to_string(player_.log().ticks) + " tick(s)");
+    return dt;
   }
+  for (SDL_Scancode key : replayPresses_) startKeyHats(project, key);
+  return player_.log().dt;
+}
 
-  if (!paused_ && totalSteps >= safety_.maxTotalStepsPerTick) {
-    pauseWithError("Safety pause: execution budget exceeded (" + std::to_string(totalSteps) + " steps).");
+int Runtime::advance(Project& project, double frameSeconds) {
+  if (!running_ || paused_) {
+    // start or resume without a burst of catch-up ticks or stale poses
+    fixedStep_.reset();
+    poses_.clear();
+    return 0;
   }
 
-  runners_.erase(std::remove_if(runners_.begin(), runners_.end(),
-                [](const ScriptRunner& r){ return r.isFinished(); }),
-                runners_.end());
+  int ticks = fixedStep_.advance(frameSeconds);
+  // a turbo tick already takes turboTickMillis; catching up would only
+  // stretch the frame
+  if (turbo_) ticks = std::min(ticks, 1);
 
-  if (runners_.empty()) running_ = false;
+  const float dt = (float)fixedStep_.tickSeconds();
+  int ran = 0;
+  for (; ran < ticks && running_ && !paused_; ++ran) {
+    poses_.capture(project);
+    tick(project, dt);
+  }
+  return ran;
 }
 
 void Runtime::step(Project& project) {
   if (!running_) return;
+  clones_ = &project.clones();
+  project.snapshotInput();
+
+  if (project.consumeStopAllScriptsRequest()) {
+    stopAll();
+    return;
+  }
+  if (project.argsRevision() != argsRevision_) refreshEditedOperands(project);
+
+  // a step stands for one tick: the clock moves on, so waits run out
+  const float dt = (float)fixedStep_.tickSeconds();
+  clock_ += dt;
+  updateSayBubbles(project, dt);
+  wakeDueRunners();
+  wakeBroadcastWaiters();
+  sensing_.rebuild(project);
 
   for (auto& r : runners_) {
     if (r.isFinished()) continue;
@@ -135,17 +909,23 @@ void Runtime::step(Project& project) {
     bool hadError = false;
     std::string errMsg;
 
-    r.tick(project, 0.0f, 1, &stepsDone, &hadError, &errMsg);
+    r.setPaused(false); // the project stays paused while stepping
+    r.tick(project, 1, &stepsDone, &hadError, &errMsg);
+    r.setPaused(paused_);
+    totalSteps_ += (uint64_t)stepsDone;
 
+    if (project.consumeStopAllScriptsRequest()) {
+      stopAll();
+      return;
+    }
     if (hadError) {
       pauseWithError(errMsg.empty() ? "Runtime error (unknown)." : errMsg);
     }
     break;
   }
 
-  runners_.erase(std::remove_if(runners_.begin(), runners_.end(),
-                [](const ScriptRunner& r){ return r.isFinished(); }),
-                runners_.end());
-
-  if (runners_.empty()) running_ = false;
+  dispatchClones(project);
+  dispatchBroadcasts(project);
+  if (profiler_.enabled()) collectProfile();
+  retireRunners();
 }
\ No newline at end of file
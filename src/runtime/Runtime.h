@@ -2,44 +2,287 @@
 #include <string>
 #include <vector>
 
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+
+#include "audio/AudioSink.h"
 #include "core/Project.h"
+#include "core/Watchdog.h"
+#include "core/WorkerPool.h"
+#include "runtime/Compiler.h"
+#include "runtime/EventIndex.h"
+#include "runtime/FixedStep.h"
+#include "runtime/Governor.h"
+#include "runtime/InputLog.h"
+#include "runtime/PoseHistory.h"
+#include "runtime/Profiler.h"
+#include "runtime/RunContext.h"
 #include "runtime/ScriptRunner.h"
+#include "runtime/SensingIndex.h"
 
 class Runtime {
 public:
+  Runtime() { ctx_.audio = &nullAudio_; ctx_.sensing = &sensing_; }
+  // runners point at ctx_, which points into this object
+  Runtime(const Runtime&) = delete;
+  Runtime& operator=(const Runtime&) = delete;
+
+  // Sound output for Play Sound / Stop All Sounds. Defaults to a null sink so
+  // the runtime works headless; the editor passes AudioEngine::instance().
+  void setAudioSink(AudioSink* sink) { audio_ = sink; ctx_.audio = &audioSink(); }
+  AudioSink& audioSink() { return audio_ ? *audio_ : nullAudio_; }
+
+  // Costume masks for pixel-accurate "touching" (the editor shares the
+  // TextureCache's); without them sprites collide as their costume squares
+  void setCollisionMasks(const CollisionMaskCache* masks) { sensing_.setMasks(masks); }
+
   void startGreenFlag(Project& project);
   void stopAll();
 
+  // "when <key> key pressed" hats for this key (and "any"), on sprites and
+  // their clones; scripts that are still running are left alone, like Scratch
+  void keyPressed(Project& project, SDL_Scancode key);
+
   void setPaused(bool p);
   bool isPaused() const { return paused_; }
-  bool isRunning() const { return running_ && !runners_.empty(); }
+  bool isRunning() const { return running_ && (!runners_.empty() || !sleeping_.empty() || !waiting_.empty()); }
+
+  // Turbo mode: tick() keeps making passes over the runners until
+  // turboTickMillis of the frame is used; each pass still ends a runner's
+  // slice at its next yield, so scripts behave as in normal mode, only more
+  // often per frame
+  void setTurbo(bool t);
+  bool turbo() const { return turbo_; }
+
+  // Parallel mode: runners are grouped by the sprite or clone they act on
+  // and the groups run on a worker pool. A runner only writes its own
+  // sprite; other sprites are sensed as they were at the start of the pass,
+  // and effects on shared state (stop all, ask, sounds, clones) are applied
+  // after the pass in runner order, so results don't depend on thread timing.
+  void setParallel(bool p, unsigned threads = 0); // 0: one per spare core
+  bool parallel() const { return parallel_; }
 
   // main update loop
   void tick(Project& project, float dt);
 
+  // Once per frame: run the ticks the frame's real time is owed at
+  // fixedStep()'s rate (none when stopped or paused), so scripts time the
+  // same at any frame rate. Returns the ticks run.
+  int advance(Project& project, double frameSeconds);
+  FixedStep& fixedStep() { return fixedStep_; }
+  const FixedStep& fixedStep() const { return fixedStep_; }
+
+  // where sprites were before the last tick, to draw them
+  // fixedStep().alpha() of the way to the next; null while nothing runs
+  const PoseHistory* poses() const { return isRunning() && !paused_ ? &poses_ : nullptr; }
+
   // step once (debug)
   void step(Project& project);
 
   // --- safety / diagnostics ---
+  uint64_t totalSteps() const { return totalSteps_; } // since green flag
   const std::string& lastError() const { return lastError_; }
   void clearError() { lastError_.clear(); }
 
+  // Budgets are caps: the governor lowers them while ticks run long, and
+  // work that doesn't fit waits for the next tick. Only a runaway script
+  // (see watchdog()) pauses the project.
   struct SafetyConfig {
     int maxStepsPerRunnerPerTick = 200;   // per runner budget
-    int maxTotalStepsPerTick     = 5000;  // global budget
-    int maxTickMillis            = 8;     // time budget (ms)
+    int maxTotalStepsPerTick     = 5000;  // global budget; the rest waits for the next tick
+    int targetTickMillis         = 6;     // rolling tick time the governor aims for (ms)
+    int maxTickMillis            = 8;     // a tick stops starting runners after this (ms)
+    int turboTickMillis          = 12;    // turbo: frame time spent on scripts (ms)
   };
   SafetyConfig& safety() { return safety_; }
   const SafetyConfig& safety() const { return safety_; }
+  const Governor& governor() const { return governor_; }
+
+  // --- watchdog ---
+  // A script that runs for limits().unyieldedMillis without yielding (in a
+  // warp script a loop end isn't a yield) pauses the project; the report
+  // names the script and the loop it is stuck in. The editor then stops just
+  // that script or lets it carry on.
+  Watchdog& watchdog() { return watchdog_; }
+  const Watchdog& watchdog() const { return watchdog_; }
+  void stopTrippedScript();   // stop the reported script, resume the rest
+  void keepTrippedScript();   // resume; its timing starts over
+
+  // --- profiling ---
+  // Off by default; when on, runners count every instruction they run and
+  // time a sample of them (see Profiler). Off costs one branch per slice.
+  void setProfiling(bool on);
+  bool profiling() const { return profiler_.enabled(); }
+  Profiler& profiler() { return profiler_; }
+  const Profiler& profiler() const { return profiler_; }
+
+  // --- random numbers ---
+  // A run's seed is setRandomSeed()'s, else the project's, else a fresh one
+  // (logged, so the run can be repeated). Each runner draws from its own
+  // stream of it, numbered in start order.
+  void setRandomSeed(uint64_t seed) { seedOverride_ = seed; } // 0: no override
+  uint64_t randomSeed() const { return runSeed_; }          // this run's
+
+  // --- input record / replay ---
+  // recordInput(): log the next green-flag run's input tick by tick (see
+  // InputLog) and write it to `path` when the run ends. replayInput(): give
+  // the next run a log's seed, tick length and input at the ticks it was
+  // recorded at; live key presses are ignored meanwhile. While either runs,
+  // ticks use the fixed caps in safety() and no clock cuts them short (turbo
+  // makes passes until maxTotalStepsPerTick instead), so a replay with the
+  // same caps repeats the recording exactly.
+  void recordInput(std::string path);
+  void replayInput(InputLog log);
+  bool recordingInput() const { return recorder_.active() || !recordNext_.empty(); }
+  bool replayingInput() const { return player_.active() || replayNext_; }
+  void finishInputRecording(); // write out a recording still running
+
+  // --- scheduling under load ---
+  // When the runners want more than maxTotalStepsPerTick the rest of the
+  // work waits for the next tick. The next pass then starts with the first
+  // runner that was cut off, and each runner gets a fair share of the
+  // budget left, so every script keeps moving (slower) instead of the
+  // early ones taking it all.
+  struct SchedulerStats {
+    bool overloaded{false};  // the last tick ran out of step budget
+    int runnable{0};         // runners that wanted to step last tick
+    int starved{0};          // ... and got no step
+    int maxStarvedTicks{0};  // longest current run of ticks without a step
+  };
+  const SchedulerStats& schedulerStats() const { return sched_; }
+
+  struct RunnerInfo {
+    int spriteId{0};
+    int scriptId{0};
+    bool clone{false};
+    int starvedTicks{0};
+  };
+  void runnerInfo(std::vector<RunnerInfo>& out) const; // runnable ones, in schedule order
 
 private:
   void pauseWithError(const std::string& msg);
+  void refreshEditedOperands(Project& project);
+  bool startHat(Project& project, EventIndex::Hat& hat, std::shared_ptr<BroadcastWait> startedBy = nullptr,
+                CloneHandle clone = {});
+  int startHatOnClones(Project& project, EventIndex::Hat& hat, std::shared_ptr<BroadcastWait> startedBy = nullptr);
+  bool dispatchBroadcasts(Project& project);
+  bool dispatchClones(Project& project);
+  void stopScript(int scriptId); // stop every runner of this script
+  template <class Pred> void stopParked(Pred pred); // sleeping/waiting runners
+  void releaseRunner(ScriptRunner& r);
+  void wakeBroadcastWaiters();
+
+  // parallel mode: the runners acting on one sprite or clone, stepped in
+  // order on one thread, and what they queued for the commit
+  struct Group {
+    size_t body{0};                // SensingIndex slot
+    std::vector<uint32_t> runners; // into runners_
+    RunContext ctx;
+    int steps{0};
+    std::string error;
+    bool tripped{false}; // the error is a watchdog trip
+    Watchdog::Report trip;
+    ProfileSink profile;
+  };
+  static constexpr size_t kMinParallelRunners = 64; // fewer: not worth waking the pool
+  bool parallelPass(Project& project, int& totalSteps, bool& progressed); // false: stopped all
+  void runGroup(Project& project, Group& g);
+  bool runaway(const Project& project, ScriptRunner& r, std::chrono::steady_clock::time_point now,
+               Watchdog::Report* out) const;
+  void pauseForWatchdog(Watchdog::Report report);
+  bool applyEffect(Project& project, const GlobalEffect& e);             // false: stopped all
+  void handOutAskAnswer(Project& project);
+  void collectProfile(bool release = false); // release: the programs may be freed next
+
+  enum class Slice { Ran, OutOfTime, EndPass, StoppedAll };
+  Slice runSlice(Project& project, ScriptRunner& r, int budget, int* steps, int& totalSteps, bool& progressed,
+                 std::chrono::steady_clock::time_point t0);
+  bool serialPass(Project& project, int& totalSteps, bool& progressed,
+                  std::chrono::steady_clock::time_point t0); // false: stopped all
+
+  void seedRun(const Project& project);
+  void startKeyHats(Project& project, SDL_Scancode key);
+  float replayTick(Project& project, float dt); // the tick length to use
+  void updateSayBubbles(Project& project, float dt);
+  void wakeDueRunners();
+  void retireRunners(); // drop finished runners, park sleeping/waiting ones
 
 private:
-  std::vector<ScriptRunner> runners_;
+  std::vector<std::shared_ptr<Program>> programs_; // compiled since green flag
+  EventIndex events_;
+  std::unordered_map<int, int> activeScripts_; // script id -> live runners
+  uint64_t argsRevision_{0};
+
+  std::vector<ScriptRunner> runners_;   // runnable this tick
+
+  // runners in WaitSeconds / PlaySoundUntilDone, kept out of runners_ so
+  // tick() never touches them; min-heap on (wakeAt, seq)
+  struct Sleeper {
+    double wakeAt{0.0};
+    uint64_t seq{0};
+    ScriptRunner runner;
+  };
+  static bool wakesLater(const Sleeper& a, const Sleeper& b);
+  std::vector<Sleeper> sleeping_;
+  uint64_t sleepSeq_{0};
+  double clock_{0.0}; // runtime seconds since green flag
+
+  // runners in broadcast-and-wait, woken once their receivers are done
+  std::vector<ScriptRunner> waiting_;
+  bool broadcastDone_{false}; // some BroadcastWait reached zero
+
+  CloneStore* clones_{nullptr}; // of the project last run; stopAll() deletes them
+
+  NullAudioSink nullAudio_;
+  AudioSink* audio_{nullptr};
+
+  SensingIndex sensing_; // rebuilt every tick
+  RunContext ctx_;       // handed to every runner
+
+  bool parallel_{false};
+  std::unique_ptr<WorkerPool> pool_;
+  std::vector<Group> groups_;          // reused across passes
+  size_t groupCount_{0};
+  std::vector<uint32_t> groupOfBody_;  // SensingIndex slot -> group, or kNoGroup
+  static constexpr uint32_t kNoGroup = UINT32_MAX;
+
+  uint64_t totalSteps_{0};
   bool running_{false};
   bool paused_{false};
+  bool turbo_{false};
 
   SafetyConfig safety_{};
   std::string lastError_;
+
+  uint64_t seedOverride_{0};
+  uint64_t runSeed_{0};
+  uint64_t runnerStarts_{0}; // this run's; the next runner's random stream
+
+  std::string recordNext_; // armed for the next green flag
+  std::string recordPath_; // of the recording running
+  InputRecorder recorder_;
+  InputLog replayLog_;     // armed for the next green flag
+  bool replayNext_{false};
+  InputPlayer player_;
+  std::vector<SDL_Scancode> replayPresses_;
+
+  FixedStep fixedStep_;
+  PoseHistory poses_; // before the last advance() tick
+
+  Governor governor_;
+  Watchdog watchdog_;
+  Profiler profiler_;
+  ProfileSink profile_; // serial passes
+  int stepBudget_{0};   // this tick's, from the governor
+  int runnerBudget_{0};
+  bool fixedBudgets_{false}; // this tick's: recording or replaying, no clock
+
+  SchedulerStats sched_;
+  size_t passStart_{0}; // where the next overloaded pass starts in runners_
+  struct Capped {       // cut off by its fair share, may get more
+    uint32_t runner;
+    int steps;
+  };
+  std::vector<Capped> capped_;
 };
\ No newline at end of file
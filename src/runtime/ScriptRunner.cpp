@@ -1,17 +1,14 @@
 #include "runtime/ScriptRunner.h"
 
 #include <algorithm>
+#include <chrono>
+#include <climits>
 #include <cmath>
-#include <cctype>
 #include <cstdlib>
 
+#include "audio/AudioSink.h"
 #include "core/Logger.h"
-#include "audio/AudioEngine.h"
-#include "ScriptRunner.h"
-
-static bool isHat(BlockType t) {
-  return t == BlockType::WhenGreenFlag || t == BlockType::WhenKeyPressed;
-}
+#include "runtime/SensingIndex.h"
 
 static const Sound* findSoundByArg(const Sprite& sp, const std::string& arg) {
   if (sp.sounds.empty()) return nullptr;
@@ -31,232 +28,103 @@ static const Sound* findSoundByArg(const Sprite& sp, const std::string& arg) {
   return nullptr;
 }
 
-float ScriptRunner::toFloat(const std::string& s, float def) {
-  if (s.empty()) return def;
-  char* end = nullptr;
-  float v = std::strtof(s.c_str(), &end);
-  if (end == s.c_str()) return def;
-  return v;
-}
-
-std::string ScriptRunner::trim(std::string s) {
-  auto notSpace = [](unsigned char c) { return !std::isspace(c); };
-  s.erase(s.begin(), std::find_if(s.begin(), s.end(), notSpace));
-  s.erase(std::find_if(s.rbegin(), s.rend(), notSpace).base(), s.end());
-  return s;
-}
-
-std::string ScriptRunner::lower(std::string s) {
-  for (char& c : s) c = (char)std::tolower((unsigned char)c);
-  return s;
-}
-
-bool ScriptRunner::cmp(float a, const std::string& op, float b) {
-  if (op == "<")  return a < b;
-  if (op == "<=") return a <= b;
-  if (op == ">")  return a > b;
-  if (op == ">=") return a >= b;
-  if (op == "==") return a == b;
-  if (op == "!=") return a != b;
-  return false;
-}
-
-bool ScriptRunner::parseDistanceComparison(const std::string& expr, std::string* outTarget, std::string* outOp, float* outValue) {
-  // forms:
-  //   distance to mouse < 50
-  //   distance to Sprite1 <= 30
-  std::string s = trim(lower(expr));
-  const std::string p = "distance to ";
-  if (s.rfind(p, 0) != 0) return false;
-  s = s.substr(p.size());
-
-  // split target and rest
-  // find first space before operator
-  size_t sp1 = s.find(' ');
-  if (sp1 == std::string::npos) return false;
-  std::string target = trim(s.substr(0, sp1));
-  std::string rest = trim(s.substr(sp1));
-
-  // op could be <= >= == != < >
-  static const char* ops[] = {"<=", ">=", "==", "!=", "<", ">"};
-  std::string op;
-  for (auto* o : ops) {
-    if (rest.rfind(o, 0) == 0) { op = o; rest = trim(rest.substr(op.size())); break; }
-  }
-  if (op.empty()) return false;
-  float v = toFloat(rest, NAN);
-  if (std::isnan(v)) return false;
-  if (outTarget) *outTarget = target;
-  if (outOp) *outOp = op;
-  if (outValue) *outValue = v;
-  return true;
-}
-
-bool ScriptRunner::parseMouseComparison(const std::string& expr, char axis, std::string* outOp, float* outValue) {
-  // mouse x > 0
-  // mouse y <= -50
-  std::string s = trim(lower(expr));
-  std::string key = (axis == 'x') ? "mouse x" : "mouse y";
-  if (s.rfind(key, 0) != 0) return false;
-  s = trim(s.substr(key.size()));
-
-  static const char* ops[] = {"<=", ">=", "==", "!=", "<", ">"};
-  std::string op;
-  for (auto* o : ops) {
-    if (s.rfind(o, 0) == 0) { op = o; s = trim(s.substr(op.size())); break; }
-  }
-  if (op.empty()) return false;
-  float v = toFloat(s, NAN);
-  if (std::isnan(v)) return false;
-  if (outOp) *outOp = op;
-  if (outValue) *outValue = v;
-  return true;
+static float distSq(float ax, float ay, float bx, float by) {
+  float dx = ax - bx;
+  float dy = ay - by;
+  return dx*dx + dy*dy;
 }
 
-bool ScriptRunner::touching(Project& project, const Sprite& sp, const std::string& target) const {
-  std::string t = trim(lower(target));
-  if (t.empty()) return false;
-
-  // edge bounds (Scratch-like)
-  if (t == "edge") {
-    return (sp.x <= -240.0f || sp.x >= 240.0f || sp.y <= -180.0f || sp.y >= 180.0f);
-  }
-
-  if (t == "mouse") {
-    if (!project.mouseWorldValid()) return false;
-    float dx = sp.x - project.mouseWorldX();
-    float dy = sp.y - project.mouseWorldY();
-    return (dx*dx + dy*dy) <= (15.0f*15.0f);
-  }
-
-  // by sprite name
-  for (const auto& other : project.sprites()) {
-    if (lower(other.name) == t) {
-      float dx = sp.x - other.x;
-      float dy = sp.y - other.y;
-      return (dx*dx + dy*dy) <= (20.0f*20.0f);
-    }
-  }
-
-  // by 1-based index
-  char* end = nullptr;
-  long idx = std::strtol(t.c_str(), &end, 10);
-  if (end && end != t.c_str() && *end == '\0') {
-    long i = idx - 1;
-    if (i >= 0 && i < (long)project.sprites().size()) {
-      const auto& other = project.sprites()[(size_t)i];
-      float dx = sp.x - other.x;
-      float dy = sp.y - other.y;
-      return (dx*dx + dy*dy) <= (20.0f*20.0f);
-    }
-  }
-
-  return false;
+size_t ScriptRunner::bodySlot(const Project& project) const {
+  return clone_.valid() ? SensingIndex::cloneBody(project, clone_.slot) : spriteSlot_;
 }
 
-float ScriptRunner::distanceTo(Project& project, const Sprite& sp, const std::string& target) const {
-  std::string t = trim(lower(target));
-  if (t == "mouse") {
-    if (!project.mouseWorldValid()) return 1e9f;
-    float dx = sp.x - project.mouseWorldX();
-    float dy = sp.y - project.mouseWorldY();
-    return std::sqrt(dx*dx + dy*dy);
-  }
-
-  for (const auto& other : project.sprites()) {
-    if (lower(other.name) == t) {
-      float dx = sp.x - other.x;
-      float dy = sp.y - other.y;
-      return std::sqrt(dx*dx + dy*dy);
-    }
-  }
-
-  char* end = nullptr;
-  long idx = std::strtol(t.c_str(), &end, 10);
-  if (end && end != t.c_str() && *end == '\0') {
-    long i = idx - 1;
-    if (i >= 0 && i < (long)project.sprites().size()) {
-      const auto& other = project.sprites()[(size_t)i];
-      float dx = sp.x - other.x;
-      float dy = sp.y - other.y;
-      return std::sqrt(dx*dx + dy*dy);
-    }
-  }
-
-  return 1e9f;
+// the index answers for our own sprite only (any sprite may be passed in)
+bool ScriptRunner::evalCondition(Project& project, const Sprite& sp, const Condition& c) const {
+  const auto& sprites = project.sprites();
+  const bool own = !clone_.valid() && spriteSlot_ < sprites.size() && &sprites[spriteSlot_] == &sp;
+  return evalAt(project, sp.x, sp.y, own ? spriteSlot_ : SIZE_MAX, c);
 }
 
-bool ScriptRunner::evalCondition(Project& project, Sprite& sp, const std::string& expr) const {
-  std::string s = trim(lower(expr));
-  if (s.empty()) return true;
-  if (s == "true") return true;
-  if (s == "false" || s == "0") return false;
-
-  // touching ...
-  if (s.rfind("touching ", 0) == 0) {
-    return touching(project, sp, trim(s.substr(std::string("touching ").size())));
-  }
-
-  // key ...
-  if (s.rfind("key ", 0) == 0) {
-    std::string key = trim(s.substr(4));
-    SDL_Scancode sc = SDL_SCANCODE_UNKNOWN;
-    if (key == "space") sc = SDL_SCANCODE_SPACE;
-    else if (key == "left") sc = SDL_SCANCODE_LEFT;
-    else if (key == "right") sc = SDL_SCANCODE_RIGHT;
-    else if (key == "up") sc = SDL_SCANCODE_UP;
-    else if (key == "down") sc = SDL_SCANCODE_DOWN;
-    else if (key.size() == 1 && key[0] >= 'a' && key[0] <= 'z') {
-      sc = (SDL_Scancode)(SDL_SCANCODE_A + (key[0] - 'a'));
+// `body`: our SensingIndex slot, SIZE_MAX to use the rough fallbacks
+bool ScriptRunner::evalAt(Project& project, float x, float y, size_t body, const Condition& c) const {
+  SensingIndex* idx = (body != SIZE_MAX && ctx_) ? ctx_->sensing : nullptr;
+  using Kind = Condition::Kind;
+  switch (c.kind) {
+    case Kind::True:  return true;
+    case Kind::False: return false;
+
+    // With a sensing index (any runner started by Runtime) these are pixel
+    // tests against the costume masks; a bare runner falls back to rough
+    // center-distance checks.
+    case Kind::TouchingEdge:
+      if (idx) return idx->touchingEdge(project, body);
+      return (x <= -240.0f || x >= 240.0f || y <= -180.0f || y >= 180.0f);
+
+    case Kind::TouchingMouse:
+      if (!project.input().mouseValid) return false;
+      if (idx) return idx->touchingPoint(project, body, project.input().mouseX, project.input().mouseY);
+      return distSq(x, y, project.input().mouseX, project.input().mouseY) <= (15.0f*15.0f);
+
+    case Kind::TouchingSprite: {
+      if (idx) return idx->touching(project, body, c.targetSpriteId);
+      const Sprite* other = project.findSpriteById(c.targetSpriteId);
+      if (!other) return false;
+      return distSq(x, y, other->x, other->y) <= (20.0f*20.0f);
+    }
+
+    case Kind::KeyDown:   return project.input().keyDown(c.key);
+    case Kind::MouseDown: return project.input().mouseDown();
+
+    case Kind::DistanceToMouse: {
+      float d = project.input().mouseValid
+        ? std::sqrt(distSq(x, y, project.input().mouseX, project.input().mouseY))
+        : 1e9f;
+      return Conditions::compare(d, c.op, c.value);
+    }
+
+    case Kind::DistanceToSprite: {
+      // the target id was resolved by name when the condition was compiled
+      float d = 1e9f;
+      if (idx) {
+        idx->distanceTo(project, body, c.targetSpriteId, d);
+      } else if (const Sprite* other = project.findSpriteById(c.targetSpriteId)) {
+        d = std::sqrt(distSq(x, y, other->x, other->y));
+      }
+      return Conditions::compare(d, c.op, c.value);
     }
-    return (sc != SDL_SCANCODE_UNKNOWN) ? project.keyDown(sc) : false;
-  }
 
-  if (s == "mouse down") return project.mouseDown();
-
-  // distance comparisons
-  std::string tgt, op;
-  float val = 0;
-  if (parseDistanceComparison(s, &tgt, &op, &val)) {
-    float d = distanceTo(project, sp, tgt);
-    return cmp(d, op, val);
-  }
-
-  // mouse x/y comparisons
-  float mv = 0;
-  if (parseMouseComparison(s, 'x', &op, &val)) {
-    mv = project.mouseWorldValid() ? project.mouseWorldX() : 0.0f;
-    return cmp(mv, op, val);
+    case Kind::MouseX:
+      return Conditions::compare(project.input().mouseValid ? project.input().mouseX : 0.0f, c.op, c.value);
+    case Kind::MouseY:
+      return Conditions::compare(project.input().mouseValid ? project.input().mouseY : 0.0f, c.op, c.value);
   }
-  if (parseMouseComparison(s, 'y', &op, &val)) {
-    mv = project.mouseWorldValid() ? project.mouseWorldY() : 0.0f;
-    return cmp(mv, op, val);
-  }
-
-  // fallback: treat as truthy string
   return true;
 }
 
-void ScriptRunner::start(Project& project, int spriteId, int scriptId) {
-  spriteId_ = spriteId;
-  scriptId_ = scriptId;
+void ScriptRunner::start(Project& project, std::shared_ptr<const Program> program, RunContext& ctx,
+                         CloneHandle clone) {
+  program_ = std::move(program);
+  ctx_ = &ctx;
+  clone_ = clone;
+  spriteId_ = program_ ? program_->spriteId : 0;
+  scriptId_ = program_ ? program_->scriptId : 0;
 
   finished_ = false;
   paused_ = false;
   waitRemaining_ = 0.0f;
   waitingAsk_ = false;
-  stack_.clear();
-
-  Sprite* sp = project.findSpriteById(spriteId_);
-  if (!sp) { finished_ = true; return; }
-
-  Script* sc = project.findScript(*sp, scriptId_);
-  if (!sc) { finished_ = true; return; }
-
-  Frame f;
-  f.headId = sc->headBlockId;
-  f.currentId = sc->headBlockId;
-  stack_.push_back(f);
+  awaiting_.reset();
+  startedBy_.reset();
+  pc_ = 0;
+  loopCounters_.clear();
+  resetUnyielded();
+
+  spriteSlot_ = SIZE_MAX;
+  if (!program_ || !curSprite(project)) { finished_ = true; return; }
+  if (clone_.valid()) {
+    if (!project.clones().alive(clone_)) finished_ = true;
+    return; // clones come and go by the thousand: not logged
+  }
 
   Logger::info("Run", "Start sprite=" + std::to_string(spriteId_) + " script=" + std::to_string(scriptId_));
 }
@@ -266,414 +134,375 @@ void ScriptRunner::stop() {
   paused_ = false;
   waitRemaining_ = 0.0f;
   waitingAsk_ = false;
-  stack_.clear();
+  awaiting_.reset();
+  loopCounters_.clear();
 }
 
+// The slot is re-resolved only when sprites were added/removed/reordered
 Sprite* ScriptRunner::curSprite(Project& project) {
-  return project.findSpriteById(spriteId_);
+  auto& sprites = project.sprites();
+  if (spriteSlot_ < sprites.size() && sprites[spriteSlot_].id == spriteId_) return &sprites[spriteSlot_];
+
+  Sprite* sp = project.findSpriteById(spriteId_);
+  spriteSlot_ = sp ? (size_t)(sp - sprites.data()) : SIZE_MAX;
+  return sp;
 }
 
-Block* ScriptRunner::curBlock(Project& project) {
-  Sprite* sp = curSprite(project);
-  if (!sp) return nullptr;
-  if (stack_.empty()) return nullptr;
-  int id = stack_.back().currentId;
-  if (id == -1) return nullptr;
-  return project.findBlock(*sp, id);
+ScriptRunner::Actor ScriptRunner::actor(Project& project, Sprite& sp) const {
+  if (!clone_.valid()) {
+    return Actor{sp, sp.x, sp.y, sp.directionDeg, sp.soundVolume, sp.soundPitch, sp.sayText, sp.sayTimeRemaining};
+  }
+  CloneStore& c = project.clones();
+  const uint32_t s = clone_.slot;
+  return Actor{sp, c.x[s], c.y[s], c.directionDeg[s], c.soundVolume[s], c.soundPitch[s],
+               c.sayText[s], c.sayTimeRemaining[s]};
 }
 
-bool ScriptRunner::stepOnce(Project& project, float dt) {
+void ScriptRunner::deferEffect(GlobalEffect e) {
+  ctx_->effects.push_back(std::move(e));
+}
+
+// keep the sensing broadphase current for runners later in this tick
+void ScriptRunner::spriteMoved(Project& project) {
+  if (ctx_ && ctx_->sensing) ctx_->sensing->moved(project, bodySlot(project));
+}
+
+template <bool Profiled>
+bool ScriptRunner::stepOnce(Project& project) {
   if (finished_ || paused_) return false;
 
   Sprite* sp = curSprite(project);
-  if (!sp) { finished_ = true; return false; }
-  if (stack_.empty()) { finished_ = true; return false; }
-
-  // wait timer
-  if (waitRemaining_ > 0.0f) {
-    waitRemaining_ -= dt;
-    if (waitRemaining_ > 0.0f) return true;
-    waitRemaining_ = 0.0f;
-  }
+  if (!sp || !program_) { finished_ = true; return false; }
+  if (clone_.valid() && !project.clones().alive(clone_)) { finished_ = true; return false; } // deleted
+
+  // sleeping: Runtime parks the runner until its wake time
+  if (waitRemaining_ > 0.0f) return false;
 
-  // ask-and-wait blocking
+  // ask-and-wait blocking (no step consumed while waiting)
   if (waitingAsk_) {
-    if (project.consumeAskAnswered()) {
-      waitingAsk_ = false;
-    } else {
-      return true;
-    }
+    if (deferred() || !project.consumeAskAnswered()) return false;
+    waitingAsk_ = false;
   }
 
-  Frame& fr = stack_.back();
-  if (fr.currentId == -1) {
-    stack_.pop_back();
-    if (stack_.empty()) { finished_ = true; return false; }
-    return true;
+  // broadcast and wait (no step consumed while receivers run)
+  if (awaiting_) {
+    if (awaiting_->pending > 0) return false;
+    awaiting_.reset();
   }
 
-  Block* b = project.findBlock(*sp, fr.currentId);
-  if (!b) {
-    fr.currentId = -1;
-    return true;
+  Actor a = actor(project, *sp);
+  const size_t body = (ctx_ && ctx_->sensing) ? bodySlot(project) : SIZE_MAX;
+  const Instr* code = program_->code.data();
+
+  // control flow bookkeeping (jumps, loop counters) does not consume a step;
+  // a taken back-edge ends the slice unless warp is on
+  for (;;) {
+    const Instr& in = code[pc_];
+    if constexpr (Profiled) {
+      ++profCells_[pc_].count;
+      profPc_ = pc_;
+    }
+    switch (in.op) {
+      case OpCode::Jump:
+        loopPc_ = pc_;
+        pc_ = in.target;
+        if (!warp_) { yield_ = true; return false; }
+        continue;
+
+      case OpCode::RepeatNext:
+        if (--loopCounters_.back() > 0) {
+          loopPc_ = pc_;
+          pc_ = in.target;
+          if (!warp_) { yield_ = true; return false; }
+        } else {
+          loopCounters_.pop_back();
+          ++pc_;
+        }
+        continue;
+
+      case OpCode::End:
+        finished_ = true;
+        return false;
+
+      case OpCode::RepeatInit: {
+        // a typed count can be NaN or past int: converting those is UB, so
+        // clamp in float first (2^31 itself doesn't fit either)
+        const float v = in.num[0];
+        const int n = (std::isnan(v) || v <= 0.0f) ? 0 : v >= 2147483648.0f ? INT_MAX : (int)v;
+        if (n == 0) {
+          pc_ = in.target;
+        } else {
+          loopCounters_.push_back(n);
+          ++pc_;
+        }
+        return true;
+      }
+
+      case OpCode::IfFalseJump:
+        pc_ = evalAt(project, a.x, a.y, body, program_->conds[(size_t)in.cond]) ? pc_ + 1 : in.target;
+        return true;
+
+      case OpCode::IfTrueJump:
+        pc_ = evalAt(project, a.x, a.y, body, program_->conds[(size_t)in.cond]) ? in.target : pc_ + 1;
+        return true;
+
+      case OpCode::Exec:
+        return execBlock(project, a, in);
+    }
   }
+}
 
-  if (isHat(b->type)) {
-    fr.currentId = b->nextId;
-    return true;
+// Out of budget right at a loop's end: take the back-edge (free) and its
+// yield in this slice, instead of spending the next slice only on that.
+void ScriptRunner::takeBackEdges() {
+  const Instr* code = program_->code.data();
+  while (!yield_) {
+    const Instr& in = code[pc_];
+    if (in.op == OpCode::Jump) {
+      pc_ = in.target;
+      yield_ = true;
+    } else if (in.op == OpCode::RepeatNext) {
+      if (--loopCounters_.back() > 0) {
+        pc_ = in.target;
+        yield_ = true;
+      } else {
+        loopCounters_.pop_back();
+        ++pc_;
+      }
+    } else {
+      return;
+    }
   }
+}
 
-  switch (b->type) {
+bool ScriptRunner::execBlock(Project& project, Actor& sp, const Instr& in) {
+  switch (in.type) {
     // ---------------- Motion ----------------
     case BlockType::MoveSteps: {
-      float steps = b->args.empty() ? 10.0f : toFloat(b->args[0], 10.0f);
-      float rad = (sp->directionDeg - 90.0f) * 3.1415926f / 180.0f;
-      sp->x += std::cos(rad) * steps;
-      sp->y += std::sin(rad) * steps;
-      fr.currentId = b->nextId;
+      float rad = (sp.directionDeg - 90.0f) * 3.1415926f / 180.0f;
+      sp.x += std::cos(rad) * in.num[0];
+      sp.y += std::sin(rad) * in.num[0];
+      spriteMoved(project);
       break;
     }
-    case BlockType::TurnRight: {
-      float deg = b->args.empty() ? 15.0f : toFloat(b->args[0], 15.0f);
-      sp->directionDeg += deg;
-      fr.currentId = b->nextId;
+    case BlockType::TurnRight:
+      sp.directionDeg += in.num[0];
       break;
-    }
-    case BlockType::TurnLeft: {
-      float deg = b->args.empty() ? 15.0f : toFloat(b->args[0], 15.0f);
-      sp->directionDeg -= deg;
-      fr.currentId = b->nextId;
+    case BlockType::TurnLeft:
+      sp.directionDeg -= in.num[0];
       break;
-    }
-    case BlockType::GoToXY: {
-      float x = (b->args.size() >= 1) ? toFloat(b->args[0], 0.0f) : 0.0f;
-      float y = (b->args.size() >= 2) ? toFloat(b->args[1], 0.0f) : 0.0f;
-      sp->x = x;
-      sp->y = y;
-      fr.currentId = b->nextId;
+    case BlockType::GoToXY:
+      sp.x = in.num[0];
+      sp.y = in.num[1];
+      spriteMoved(project);
       break;
-    }
-    case BlockType::SetX: {
-      sp->x = b->args.empty() ? 0.0f : toFloat(b->args[0], 0.0f);
-      fr.currentId = b->nextId;
+    case BlockType::SetX:
+      sp.x = in.num[0];
+      spriteMoved(project);
       break;
-    }
-    case BlockType::SetY: {
-      sp->y = b->args.empty() ? 0.0f : toFloat(b->args[0], 0.0f);
-      fr.currentId = b->nextId;
+    case BlockType::SetY:
+      sp.y = in.num[0];
+      spriteMoved(project);
       break;
-    }
-    case BlockType::ChangeXBy: {
-      sp->x += b->args.empty() ? 10.0f : toFloat(b->args[0], 10.0f);
-      fr.currentId = b->nextId;
+    case BlockType::ChangeXBy:
+      sp.x += in.num[0];
+      spriteMoved(project);
       break;
-    }
-    case BlockType::ChangeYBy: {
-      sp->y += b->args.empty() ? 10.0f : toFloat(b->args[0], 10.0f);
-      fr.currentId = b->nextId;
+    case BlockType::ChangeYBy:
+      sp.y += in.num[0];
+      spriteMoved(project);
       break;
-    }
     case BlockType::GoToRandomPosition: {
-      float rx = -240.0f + (std::rand() / (float)RAND_MAX) * 480.0f;
-      float ry = -180.0f + (std::rand() / (float)RAND_MAX) * 360.0f;
-      sp->x = rx;
-      sp->y = ry;
-      fr.currentId = b->nextId;
+      sp.x = (float)random_.range(-240.0, 240.0);
+      sp.y = (float)random_.range(-180.0, 180.0);
+      spriteMoved(project);
       break;
     }
     case BlockType::GoToMousePointer: {
-      if (project.mouseWorldValid()) {
-        sp->x = project.mouseWorldX();
-        sp->y = project.mouseWorldY();
+      if (project.input().mouseValid) {
+        sp.x = project.input().mouseX;
+        sp.y = project.input().mouseY;
+        spriteMoved(project);
       }
-      fr.currentId = b->nextId;
       break;
     }
 
     // ---------------- Looks ----------------
-    case BlockType::Say: {
-      std::string msg = b->args.empty() ? "Hello!" : b->args[0];
-      // {answer} token
-      size_t pos = msg.find("{answer}");
-      if (pos != std::string::npos) msg.replace(pos, 8, project.answer());
-      sp->sayText = msg;
-      sp->sayTimeRemaining = 2.0f;
-      fr.currentId = b->nextId;
-      break;
-    }
+    case BlockType::Say:
     case BlockType::Think: {
-      std::string msg = b->args.empty() ? "Hmm..." : b->args[0];
+      std::string msg = program_->strings[(size_t)in.str];
+      // {answer} token
       size_t pos = msg.find("{answer}");
       if (pos != std::string::npos) msg.replace(pos, 8, project.answer());
-      sp->sayText = msg;
-      sp->sayTimeRemaining = 2.0f;
-      fr.currentId = b->nextId;
+      sp.sayText = msg;
+      sp.sayTimeRemaining = 2.0f;
       break;
     }
 
     // ---------------- Control ----------------
-    case BlockType::WaitSeconds: {
-      float sec = b->args.empty() ? 1.0f : toFloat(b->args[0], 1.0f);
-      waitRemaining_ = std::max(0.0f, sec);
-      fr.currentId = b->nextId;
+    case BlockType::WaitSeconds:
+      waitRemaining_ = std::max(0.0f, in.num[0]);
       break;
-    }
 
     case BlockType::WaitUntil: {
-      std::string cond = b->args.empty() ? std::string{} : b->args[0];
-      if (evalCondition(project, *sp, cond)) {
-        fr.currentId = b->nextId;
-      } else {
-        fr.currentId = b->id; // stay
+      const size_t body = (ctx_ && ctx_->sensing) ? bodySlot(project) : SIZE_MAX;
+      if (!evalAt(project, sp.x, sp.y, body, program_->conds[(size_t)in.cond])) {
+        // stay and re-test next tick; a wait isn't work, even in warp
+        yield_ = true;
+        return false;
       }
       break;
     }
 
-    case BlockType::IfThen: {
-      std::string cond = b->args.empty() ? std::string{} : b->args[0];
-      bool ok = evalCondition(project, *sp, cond);
-      if (ok && b->childHeadId != -1) {
-        Frame child;
-        child.headId = b->childHeadId;
-        child.currentId = b->childHeadId;
-        child.ownerControlId = b->id;
-        stack_.push_back(child);
-      } else {
-        fr.currentId = b->nextId;
-      }
-      break;
-    }
+    case BlockType::StopThisScript:
+      stop();
+      return false;
 
-    case BlockType::Repeat: {
-      int n = 10;
-      if (!b->args.empty()) n = (int)toFloat(b->args[0], 10.0f);
-      n = std::max(0, n);
+    case BlockType::StopAll:
+      if (deferred()) deferEffect({.kind = GlobalEffect::Kind::StopAll});
+      else project.requestStopAllScripts();
+      stop();
+      return false;
 
-      if (b->childHeadId == -1 || n == 0) {
-        fr.currentId = b->nextId;
+    // ---------------- Clones ----------------
+    case BlockType::CreateCloneOf: {
+      CloneStore& clones = project.clones();
+      if (deferred()) {
+        // copy ourselves as we are now; another sprite is copied after the pass
+        if (in.sprite == 0) {
+          deferEffect({.kind = GlobalEffect::Kind::CreateClone,
+                       .clone = clone_.valid() ? clones.stateOf(clone_) : CloneStore::stateOf(sp.sprite)});
+        } else if (in.sprite > 0) {
+          deferEffect({.kind = GlobalEffect::Kind::CreateClone, .target = in.sprite});
+        }
         break;
       }
-
-      Frame ctrl;
-      ctrl.ownerControlId = b->id;
-      ctrl.repeatRemaining = n;
-      ctrl.controlMode = 1;
-      ctrl.headId = b->childHeadId;
-      ctrl.currentId = b->childHeadId;
-      stack_.push_back(ctrl);
-      break;
-    }
-
-    case BlockType::RepeatUntil: {
-      if (b->childHeadId == -1) {
-        fr.currentId = b->nextId;
-        break;
+      CloneHandle h;
+      if (in.sprite == 0) {
+        h = clone_.valid() ? clones.spawn(clone_) : clones.spawn(sp.sprite);
+      } else if (const Sprite* target = in.sprite > 0 ? project.findSpriteById(in.sprite) : nullptr) {
+        h = clones.spawn(*target);
       }
-      std::string cond = b->args.empty() ? std::string{} : b->args[0];
-      if (evalCondition(project, *sp, cond)) {
-        fr.currentId = b->nextId;
-        break;
+      if (h.valid() && ctx_) {
+        ctx_->clonesStarted.push_back(h); // Runtime starts its hats after this pass
+        if (ctx_->sensing) ctx_->sensing->moved(project, SensingIndex::cloneBody(project, h.slot));
       }
-      Frame ctrl;
-      ctrl.ownerControlId = b->id;
-      ctrl.repeatRemaining = 0;
-      ctrl.controlMode = 3;
-      ctrl.headId = b->childHeadId;
-      ctrl.currentId = b->childHeadId;
-      stack_.push_back(ctrl);
       break;
     }
 
-    case BlockType::Forever: {
-      if (b->childHeadId == -1) {
-        fr.currentId = b->nextId;
-        break;
+    case BlockType::DeleteThisClone:
+      if (!clone_.valid()) break; // the sprite itself stays
+      if (deferred()) {
+        deferEffect({.kind = GlobalEffect::Kind::DeleteClone, .handle = clone_});
+      } else {
+        project.clones().release(clone_);
+        if (ctx_) ctx_->cloneDeleted = true;
       }
-      Frame ctrl;
-      ctrl.ownerControlId = b->id;
-      ctrl.repeatRemaining = -1;
-      ctrl.controlMode = 2;
-      ctrl.headId = b->childHeadId;
-      ctrl.currentId = b->childHeadId;
-      stack_.push_back(ctrl);
-      break;
-    }
-
-    case BlockType::StopThisScript: {
       stop();
       return false;
-    }
 
-    case BlockType::StopAll: {
-      project.requestStopAllScripts();
-      stop();
-      return false;
-    }
+    // ---------------- Events ----------------
+    case BlockType::Broadcast:
+      if (ctx_) ctx_->broadcasts.push_back({in.msg, nullptr});
+      break;
+
+    case BlockType::BroadcastAndWait:
+      if (!ctx_) break;
+      awaiting_ = std::make_shared<BroadcastWait>();
+      ctx_->broadcasts.push_back({in.msg, awaiting_});
+      yield_ = true; // Runtime starts the receivers after this pass
+      break;
 
     // ---------------- Sensing ----------------
-    case BlockType::AskAndWait: {
-      std::string q = b->args.empty() ? std::string("?") : b->args[0];
-      project.beginAsk(q);
+    case BlockType::AskAndWait:
+      if (deferred()) deferEffect({.kind = GlobalEffect::Kind::Ask, .prompt = &program_->strings[(size_t)in.str]});
+      else project.beginAsk(program_->strings[(size_t)in.str]);
       waitingAsk_ = true;
-      fr.currentId = b->nextId;
       break;
-    }
 
     // ---------------- Sound ----------------
     case BlockType::PlaySound:
     case BlockType::PlaySoundUntilDone: {
-      std::string which = b->args.empty() ? std::string{} : b->args[0];
-      const Sound* snd = findSoundByArg(*sp, which);
+      const std::string& which = program_->strings[(size_t)in.str];
+      const Sound* snd = findSoundByArg(sp.sprite, which);
       if (!snd) {
         Logger::warn("Sound", "No sound found for arg='" + which + "'");
-        fr.currentId = b->nextId;
-        break;
-      }
-      if (snd->muted || snd->volume <= 0.0f) {
-        fr.currentId = b->nextId;
         break;
       }
+      if (snd->muted || snd->volume <= 0.0f || !ctx_->audio) break;
 
-      float vol = (sp->soundVolume / 100.0f) * snd->volume;
+      float vol = (sp.soundVolume / 100.0f) * snd->volume;
       vol = std::clamp(vol, 0.0f, 1.0f);
-      float pitch = sp->soundPitch;
+      float pitch = sp.soundPitch;
 
-      auto pr = AudioEngine::instance().playWav(snd->filePath, vol, pitch);
-      if (b->type == BlockType::PlaySoundUntilDone && pr.durationSec > 0.0f) {
-        waitRemaining_ = pr.durationSec;
+      if (deferred()) {
+        const bool untilDone = in.type == BlockType::PlaySoundUntilDone;
+        deferEffect({.kind = GlobalEffect::Kind::PlaySound, .sound = snd, .volume = vol, .pitch = pitch,
+                     .untilDone = untilDone});
+        if (untilDone) yield_ = true; // Runtime puts us to sleep after the pass
+        break;
       }
 
-      fr.currentId = b->nextId;
+      auto pr = ctx_->audio->playWav(snd->filePath, vol, pitch);
+      if (in.type == BlockType::PlaySoundUntilDone && pr.durationSec > 0.0f) {
+        waitRemaining_ = pr.durationSec;
+      }
       break;
     }
 
-    case BlockType::StopAllSounds: {
-      AudioEngine::instance().stopAll();
-      fr.currentId = b->nextId;
+    case BlockType::StopAllSounds:
+      if (deferred()) deferEffect({.kind = GlobalEffect::Kind::StopAllSounds});
+      else if (ctx_->audio) ctx_->audio->stopAll();
       break;
-    }
 
-    case BlockType::SetVolumeTo: {
-      float v = b->args.empty() ? 100.0f : toFloat(b->args[0], 100.0f);
-      sp->soundVolume = std::clamp(v, 0.0f, 100.0f);
-      fr.currentId = b->nextId;
+    case BlockType::SetVolumeTo:
+      sp.soundVolume = std::clamp(in.num[0], 0.0f, 100.0f);
       break;
-    }
 
-    case BlockType::ChangeVolumeBy: {
-      float dv = b->args.empty() ? 10.0f : toFloat(b->args[0], 10.0f);
-      sp->soundVolume = std::clamp(sp->soundVolume + dv, 0.0f, 100.0f);
-      fr.currentId = b->nextId;
+    case BlockType::ChangeVolumeBy:
+      sp.soundVolume = std::clamp(sp.soundVolume + in.num[0], 0.0f, 100.0f);
       break;
-    }
 
-    case BlockType::SetPitchTo: {
-      float p = b->args.empty() ? 0.0f : toFloat(b->args[0], 0.0f);
-      sp->soundPitch = std::clamp(p, -24.0f, 24.0f);
-      fr.currentId = b->nextId;
+    case BlockType::SetPitchTo:
+      sp.soundPitch = std::clamp(in.num[0], -24.0f, 24.0f);
       break;
-    }
 
-    case BlockType::ChangePitchBy: {
-      float dp = b->args.empty() ? 1.0f : toFloat(b->args[0], 1.0f);
-      sp->soundPitch = std::clamp(sp->soundPitch + dp, -24.0f, 24.0f);
-      fr.currentId = b->nextId;
+    case BlockType::ChangePitchBy:
+      sp.soundPitch = std::clamp(sp.soundPitch + in.num[0], -24.0f, 24.0f);
       break;
-    }
 
     default:
-      fr.currentId = b->nextId;
       break;
   }
 
-  // unwind finished frames / control re-entry
-  while (!stack_.empty()) {
-    Frame& top = stack_.back();
-    if (top.currentId != -1) break;
-
-    int owner = top.ownerControlId;
-    int remaining = top.repeatRemaining;
-    int mode = top.controlMode;
-    int head = top.headId;
-    stack_.pop_back();
-
-    if (owner == 0) continue;
-
-    if (mode == 2) {
-      // forever
-      Frame ctrl;
-      ctrl.ownerControlId = owner;
-      ctrl.repeatRemaining = -1;
-      ctrl.controlMode = 2;
-      ctrl.headId = head;
-      ctrl.currentId = head;
-      stack_.push_back(ctrl);
-      break;
-    }
-
-    if (mode == 3) {
-      // repeat-until: check condition on owner block
-      Sprite* spr = curSprite(project);
-      if (spr) {
-        Block* ownerBlock = project.findBlock(*spr, owner);
-        std::string cond = ownerBlock && !ownerBlock->args.empty() ? ownerBlock->args[0] : std::string{};
-        bool done = ownerBlock ? evalCondition(project, *spr, cond) : true;
-        if (!done) {
-          Frame ctrl;
-          ctrl.ownerControlId = owner;
-          ctrl.repeatRemaining = 0;
-          ctrl.controlMode = 3;
-          ctrl.headId = head;
-          ctrl.currentId = head;
-          stack_.push_back(ctrl);
-          break;
-        }
-        // done: advance owner in parent frame
-        if (ownerBlock) {
-          for (int i = (int)stack_.size() - 1; i >= 0; --i) {
-            if (stack_[i].currentId == owner) {
-              stack_[i].currentId = ownerBlock->nextId;
-              break;
-            }
-          }
-        }
-      }
-      continue;
-    }
+  ++pc_;
+  return true;
+}
 
-    // repeat(count)
-    remaining--;
-    if (remaining > 0) {
-      Frame ctrl;
-      ctrl.ownerControlId = owner;
-      ctrl.repeatRemaining = remaining;
-      ctrl.controlMode = 1;
-      ctrl.headId = head;
-      ctrl.currentId = head;
-      stack_.push_back(ctrl);
-      break;
+// The tick loop with profiling: every instruction visited is counted, and
+// one step in ProfileSink::kSampleEvery is timed for the instruction it ran.
+int ScriptRunner::profiledSlice(Project& project, int maxSteps) {
+  ProfileSink& sink = *ctx_->profile;
+  profCells_ = sink.cells(program_);
+  int steps = 0;
+  while (!finished_ && !paused_ && steps < maxSteps) {
+    bool stepped;
+    if (sink.sampleNext()) {
+      const auto t0 = std::chrono::steady_clock::now();
+      stepped = stepOnce<true>(project);
+      const std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - t0;
+      profCells_[profPc_].ns += (uint64_t)ns.count() * ProfileSink::kSampleEvery;
     } else {
-      // finished: advance owner block to next
-      Sprite* spr = curSprite(project);
-      if (spr) {
-        Block* ownerBlock = project.findBlock(*spr, owner);
-        if (ownerBlock) {
-          for (int i = (int)stack_.size() - 1; i >= 0; --i) {
-            if (stack_[i].currentId == owner) {
-              stack_[i].currentId = ownerBlock->nextId;
-              break;
-            }
-          }
-        }
-      }
+      stepped = stepOnce<true>(project);
     }
+    if (!stepped) break;
+    steps++;
+    if (yield_) break;
   }
-
-  return true;
+  return steps;
 }
 
 void ScriptRunner::tick(Project& project,
-                       float dt,
                        int maxStepsPerTick,
                        int* outSteps,
                        bool* outHadError,
@@ -684,23 +513,19 @@ void ScriptRunner::tick(Project& project,
 
   if (finished_ || paused_) return;
 
-  // update say bubble timer
-  if (Sprite* sp = curSprite(project)) {
-    if (sp->sayTimeRemaining > 0.0f) {
-      sp->sayTimeRemaining -= dt;
-      if (sp->sayTimeRemaining <= 0.0f) {
-        sp->sayTimeRemaining = 0.0f;
-        sp->sayText.clear();
-      }
-    }
-  }
-
   int steps = 0;
+  yield_ = false;
   try {
-    while (!finished_ && !paused_ && steps < maxStepsPerTick) {
-      if (!stepOnce(project, dt)) break;
-      steps++;
+    if (ctx_ && ctx_->profile) {
+      steps = profiledSlice(project, maxStepsPerTick);
+    } else {
+      while (!finished_ && !paused_ && steps < maxStepsPerTick) {
+        if (!stepOnce<false>(project)) break;
+        steps++;
+        if (yield_) break;
+      }
     }
+    if (steps >= maxStepsPerTick && !yield_ && !finished_ && !warp_) takeBackEdges();
   } catch (const std::exception& ex) {
     finished_ = true;
     if (outHadError) *outHadError = true;
@@ -711,5 +536,13 @@ void ScriptRunner::tick(Project& project,
     if (outErrorMsg) *outErrorMsg = "Script error: unknown exception";
   }
 
+  // a slice that ran its whole budget without yielding or waiting adds up;
+  // warp's loop ends don't yield, so they don't start the count over
+  if (yield_ || finished_ || steps < maxStepsPerTick) {
+    resetUnyielded();
+  } else {
+    unyieldedSteps_ += (uint32_t)steps;
+  }
+
   if (outSteps) *outSteps = steps;
 }
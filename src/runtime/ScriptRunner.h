@@ -2,66 +2,159 @@
 #include <string>
 #include <vector>
 
-#include "core/Project.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
 
-struct Frame {
-  int headId{-1};         // start of this frame chain
-  int currentId{-1};      // current executing block in chain
-  int ownerControlId{0};  // which control block created this frame
-  int repeatRemaining{0}; // for Repeat
-  int controlMode{0};     // 0 none, 1 repeat(count), 2 forever, 3 repeat-until
-};
+#include "core/Project.h"
+#include "core/Random.h"
+#include "runtime/Compiler.h"
+#include "runtime/Profiler.h"
+#include "runtime/RunContext.h"
 
 class ScriptRunner {
 public:
   ScriptRunner() = default;
 
-  void start(Project& project, int spriteId, int scriptId);
+  // `clone`: run as that clone of the program's sprite instead of the sprite
+  void start(Project& project, std::shared_ptr<const Program> program, RunContext& ctx,
+             CloneHandle clone = {});
   void stop();
 
   bool isFinished() const { return finished_; }
   bool isPaused() const { return paused_; }
-  void setPaused(bool p) { paused_ = p; }
+  void setPaused(bool p) { paused_ = p; unyieldedSince_ = {}; } // a pause isn't running
 
   int spriteId() const { return spriteId_; }
   int scriptId() const { return scriptId_; }
+  CloneHandle clone() const { return clone_; }
+
+  // this runner's own stream of the run's random numbers; Runtime seeds it
+  // before start()
+  void seedRandom(uint64_t seed, uint64_t stream) { random_.seed(seed, stream); }
+  Random& random() { return random_; }
+
+  // Runtime points the runner at a per-group context for a parallel pass
+  void setContext(RunContext& ctx) { ctx_ = &ctx; }
+
+  // WaitSeconds / PlaySoundUntilDone: the runner stops stepping and Runtime
+  // parks it until clock + sleepSeconds()
+  bool isSleeping() const { return waitRemaining_ > 0.0f; }
+  float sleepSeconds() const { return waitRemaining_; }
+  void wake() { waitRemaining_ = 0.0f; }
+  void sleep(float seconds) { waitRemaining_ = seconds; } // deferred PlaySoundUntilDone
+
+  // ask and wait; in a parallel pass Runtime hands out the answer
+  bool isWaitingAsk() const { return waitingAsk_; }
+  void answerAsk() { waitingAsk_ = false; }
+
+  // Warp ("run without screen refresh"): loop back-edges don't yield, so the
+  // runner keeps going until its step budget runs out. An unmet WaitUntil
+  // still ends the slice without using a step. Turbo mode doesn't use it.
+  void setWarp(bool w) { warp_ = w; }
+  bool warp() const { return warp_; }
+
+  // Broadcast and wait: blocked until every receiver it started has
+  // finished; Runtime parks the runner meanwhile
+  bool isAwaitingBroadcast() const { return awaiting_ && awaiting_->pending > 0; }
+
+  // set by Runtime on receivers started by a broadcast-and-wait; Runtime
+  // counts it down when this runner finishes or is stopped
+  void setStartedBy(std::shared_ptr<BroadcastWait> w) { startedBy_ = std::move(w); }
+  std::shared_ptr<BroadcastWait> takeStartedBy() { return std::move(startedBy_); }
+
+  // last tick() ended on a yield (loop end, unmet WaitUntil, ...) rather
+  // than on its step budget
+  bool yielded() const { return yield_; }
+
+  // scheduling under load: ticks in a row this runner was runnable but the
+  // global step budget ran out before its turn
+  int starvedTicks() const { return starvedTicks_; }
+  void setStarved(bool starved) { starvedTicks_ = starved ? starvedTicks_ + 1 : 0; }
+
+  // watchdog: instructions run since the runner last yielded (loop end
+  // outside warp, wait, end of script); updated once per slice. loopPc() is
+  // the back-edge it took last since then (-1: none), the loop it is stuck in.
+  // unyieldedSince(now): when Runtime first saw that stretch, stamped `now`
+  // the first time it asks.
+  uint32_t unyieldedSteps() const { return unyieldedSteps_; }
+  int loopPc() const { return loopPc_; }
+  std::chrono::steady_clock::time_point unyieldedSince(std::chrono::steady_clock::time_point now) {
+    if (unyieldedSince_ == std::chrono::steady_clock::time_point{}) unyieldedSince_ = now;
+    return unyieldedSince_;
+  }
+  void resetUnyielded() { unyieldedSteps_ = 0; loopPc_ = -1; unyieldedSince_ = {}; }
+  const Program* program() const { return program_.get(); }
+  int pc() const { return pc_; }
 
   void tick(Project& project,
-            float dt,
             int maxStepsPerTick,
             int* outSteps,
             bool* outHadError,
             std::string* outErrorMsg);
 
+  // --- Sensing / conditions (pre-compiled, see runtime/Condition.h) ---
+  bool evalCondition(Project& project, const Sprite& sp, const Condition& c) const;
+
 private:
-  bool stepOnce(Project& project, float dt);
+  // What the blocks act on: the sprite's own state, or its clone's slot in
+  // Project::clones(). Costumes and sounds always come from `sprite`.
+  struct Actor {
+    Sprite& sprite;
+    float& x;
+    float& y;
+    float& directionDeg;
+    float& soundVolume;
+    float& soundPitch;
+    std::string& sayText;
+    float& sayTimeRemaining;
+  };
+  Actor actor(Project& project, Sprite& sp) const;
+
+  template <bool Profiled> bool stepOnce(Project& project);
+  int profiledSlice(Project& project, int maxSteps);
+  void takeBackEdges();
+  bool execBlock(Project& project, Actor& a, const Instr& in);
+  bool evalAt(Project& project, float x, float y, size_t body, const Condition& c) const;
   Sprite* curSprite(Project& project);
-  Block* curBlock(Project& project);
-
-  static float toFloat(const std::string& s, float def);
-
-  // --- Sensing / conditions (simple expressions) ---
-  bool evalCondition(Project& project, Sprite& sp, const std::string& expr) const;
-  bool touching(Project& project, const Sprite& sp, const std::string& target) const;
-  float distanceTo(Project& project, const Sprite& sp, const std::string& target) const;
-
-  static std::string trim(std::string s);
-  static std::string lower(std::string s);
-
-  static bool parseDistanceComparison(const std::string& expr, std::string* outTarget, std::string* outOp, float* outValue);
-  static bool parseMouseComparison(const std::string& expr, char axis, std::string* outOp, float* outValue);
-  static bool cmp(float a, const std::string& op, float b);
+  size_t bodySlot(const Project& project) const; // ours in the SensingIndex
+  bool deferred() const { return ctx_ && ctx_->deferGlobal; }
+  void deferEffect(GlobalEffect e);
+  void spriteMoved(Project& project);
 
 private:
   int spriteId_{0};
   int scriptId_{0};
+  CloneHandle clone_;           // invalid: the sprite itself
+  size_t spriteSlot_{SIZE_MAX}; // cached index into project.sprites(), checked per step
   bool finished_{true};
   bool paused_{false};
 
-  std::vector<Frame> stack_;
+  std::shared_ptr<const Program> program_;
+  RunContext* ctx_{nullptr};
+  int pc_{0};
+  std::vector<int> loopCounters_; // one per active Repeat
 
   float waitRemaining_{0.0f};
+  Random random_;
+
+  // Scratch-style yield: set at the end of a loop iteration or by an unmet
+  // WaitUntil, ends this tick's slice
+  bool yield_{false};
+  bool warp_{false};
+
+  // profiled slice only: this program's counters and the pc of the last step
+  ProfileSink::Cell* profCells_{nullptr};
+  int profPc_{0};
 
   // ask-and-wait state
   bool waitingAsk_{false};
+
+  int starvedTicks_{0};
+  uint32_t unyieldedSteps_{0};
+  int loopPc_{-1};
+  std::chrono::steady_clock::time_point unyieldedSince_{}; // unset: not timed yet
+
+  std::shared_ptr<BroadcastWait> awaiting_;  // broadcast-and-wait in progress
+  std::shared_ptr<BroadcastWait> startedBy_; // the wait we count toward
 };
@@ -0,0 +1,290 @@
+#include "runtime/SensingIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "core/Project.h"
+#include "model/CollisionMask.h"
+
+namespace {
+
+int stagePixel(float v) {
+  return (int)std::lround(std::clamp(v, -1.0e6f, 1.0e6f));
+}
+
+} // namespace
+
+int SensingIndex::cellOf(float v) {
+  // clamp so far-off sprites don't overflow the cell math
+  v = std::clamp(v, -1.0e6f, 1.0e6f);
+  return (int)std::floor(v / kCellSize);
+}
+
+SensingIndex::Cells SensingIndex::cellsOf(const Body& b) {
+  const float r = (float)Collision::extentFor(b.side);
+  return Cells{cellOf(b.x - r), cellOf(b.y - r), cellOf(b.x + r), cellOf(b.y + r)};
+}
+
+size_t SensingIndex::bucketOf(int cx, int cy) {
+  uint32_t h = (uint32_t)cx * 0x9E3779B1u ^ (uint32_t)cy * 0x85EBCA77u;
+  return (h ^ (h >> 15)) & (kBuckets - 1);
+}
+
+size_t SensingIndex::cloneBody(const Project& project, uint32_t cloneSlot) {
+  return project.sprites().size() + cloneSlot;
+}
+
+size_t SensingIndex::bodyCount(const Project& project) {
+  return project.sprites().size() + project.clones().capacity();
+}
+
+bool SensingIndex::body(const Project& project, size_t slot, Body& out) {
+  const auto& sprites = project.sprites();
+  if (slot < sprites.size()) {
+    const Sprite& sp = sprites[slot];
+    out = Body{&sp, sp.x, sp.y, sp.directionDeg, sp.stageSize(), sp.currentCostume, sp.visible};
+    return true;
+  }
+
+  const CloneStore& clones = project.clones();
+  const uint32_t s = (uint32_t)(slot - sprites.size());
+  if (s >= clones.capacity() || !clones.alive(clones.handle(s))) return false;
+  const Sprite* parent = project.findSpriteById(clones.parentId[s]);
+  if (!parent) return false;
+  out = Body{parent, clones.x[s], clones.y[s], clones.directionDeg[s],
+             Sprite::stageSizeFor(clones.sizePercent[s]), clones.currentCostume[s], clones.visible[s] != 0};
+  return true;
+}
+
+int SensingIndex::cloneParentOf(const Project& project, uint32_t s) {
+  const CloneStore& clones = project.clones();
+  return (s < clones.capacity() && clones.alive(clones.handle(s))) ? clones.parentId[s] : 0;
+}
+
+// bucketed by the footprint's rotation-independent extent, so turning or
+// switching costume never needs a re-insert
+void SensingIndex::insert(size_t slot, const Body& b) {
+  const Cells c = cellsOf(b);
+  entries_[slot].cells = c;
+  for (int cy = c.cy0; cy <= c.cy1; ++cy) {
+    for (int cx = c.cx0; cx <= c.cx1; ++cx) buckets_[bucketOf(cx, cy)].push_back((uint32_t)slot);
+  }
+}
+
+void SensingIndex::remove(size_t slot) {
+  const Cells c = entries_[slot].cells;
+  for (int cy = c.cy0; cy <= c.cy1; ++cy) {
+    for (int cx = c.cx0; cx <= c.cx1; ++cx) {
+      auto& b = buckets_[bucketOf(cx, cy)];
+      auto it = std::find(b.begin(), b.end(), (uint32_t)slot);
+      if (it != b.end()) { *it = b.back(); b.pop_back(); }
+    }
+  }
+  entries_[slot].cells = Cells{};
+}
+
+void SensingIndex::rebuild(const Project& project) {
+  const auto& sprites = project.sprites();
+  if (buckets_.size() != kBuckets) buckets_.resize(kBuckets);
+  for (auto& b : buckets_) b.clear(); // keeps capacity from last tick
+
+  // entries keep their footprints; footprint() notices a different sprite
+  entries_.resize(bodyCount(project));
+  for (auto& e : entries_) {
+    e.cells = Cells{};
+    e.present = false;
+  }
+
+  Body b;
+  for (size_t i = 0; i < sprites.size(); ++i) {
+    body(project, i, b);
+    insert(i, b);
+    entries_[i].snap = b;
+    entries_[i].present = true;
+  }
+  for (uint32_t s : project.clones().live()) {
+    const size_t slot = cloneBody(project, s);
+    if (!body(project, slot, b)) continue;
+    insert(slot, b);
+    entries_[slot].snap = b;
+    entries_[slot].present = true;
+  }
+}
+
+void SensingIndex::freeze() {
+  if (fpStateSize_ < entries_.size()) {
+    fpState_.reset(new std::atomic<uint8_t>[entries_.size()]);
+    fpStateSize_ = entries_.size();
+  }
+  for (size_t i = 0; i < entries_.size(); ++i) fpState_[i].store(kFpUnchecked, std::memory_order_relaxed);
+  frozen_ = true;
+}
+
+bool SensingIndex::spritePosition(const Project& project, int id, float& x, float& y) const {
+  const Sprite* sp = project.findSpriteById(id);
+  if (!sp) return false;
+  const size_t slot = (size_t)(sp - project.sprites().data());
+  if (frozen_ && slot < entries_.size() && entries_[slot].present) {
+    x = entries_[slot].snap.x;
+    y = entries_[slot].snap.y;
+  } else {
+    x = sp->x;
+    y = sp->y;
+  }
+  return true;
+}
+
+bool SensingIndex::distanceTo(const Project& project, size_t selfSlot, int targetId, float& d) const {
+  Body self;
+  float ox = 0.0f, oy = 0.0f;
+  if (!body(project, selfSlot, self) || !spritePosition(project, targetId, ox, oy)) return false;
+  d = std::hypot(self.x - ox, self.y - oy);
+  return true;
+}
+
+void SensingIndex::ensureCurrent(const Project& project) {
+  if (frozen_) return; // nothing is added or removed during a parallel pass
+  if (entries_.size() != bodyCount(project)) rebuild(project); // sprites added/removed mid-tick
+}
+
+// also how a clone spawned mid-tick gets in
+void SensingIndex::moved(const Project& project, size_t slot) {
+  if (frozen_) return; // others keep seeing the snapshot
+  if (entries_.size() != bodyCount(project)) return; // rebuilt on next query
+
+  Body b;
+  if (!body(project, slot, b)) return;
+  const Cells c = cellsOf(b);
+  const Cells& e = entries_[slot].cells;
+  if (c.cx0 == e.cx0 && c.cx1 == e.cx1 && c.cy0 == e.cy0 && c.cy1 == e.cy1) {
+    return; // still in the same cells
+  }
+  remove(slot);
+  insert(slot, b);
+}
+
+const Collision::Footprint& SensingIndex::footprint(const Body& b, size_t slot) {
+  Entry& e = entries_[slot];
+
+  const Costume* c = b.sprite->costumeAt(b.costume);
+  const int costume = c ? (int)(c - b.sprite->costumes.data()) : -1;
+  const uint64_t rev = masks_ ? masks_->revision() : 0;
+
+  if (e.spriteId != b.sprite->id || e.costume != costume || e.maskRevision != rev ||
+      e.side != b.side || e.dir != b.dir) {
+    const CollisionMask* mask = (masks_ && c) ? masks_->find(c->imagePath) : nullptr;
+    Collision::build(e.fp, mask, b.side, b.dir);
+    e.spriteId = b.sprite->id;
+    e.costume = costume;
+    e.maskRevision = rev;
+    e.side = b.side;
+    e.dir = b.dir;
+  }
+  return e.fp;
+}
+
+// another body's snapshot footprint during a parallel pass
+const Collision::Footprint& SensingIndex::snapFootprint(size_t slot) {
+  std::atomic<uint8_t>& state = fpState_[slot];
+  if (state.load(std::memory_order_acquire) != kFpReady) {
+    uint8_t expected = kFpUnchecked;
+    if (state.compare_exchange_strong(expected, kFpBuilding, std::memory_order_acquire)) {
+      footprint(entries_[slot].snap, slot);
+      state.store(kFpReady, std::memory_order_release);
+    } else {
+      while (state.load(std::memory_order_acquire) != kFpReady) std::this_thread::yield();
+    }
+  }
+  return entries_[slot].fp;
+}
+
+// the querying body's footprint: the shared one unless it has turned,
+// resized or changed costume since the snapshot, then a per-thread copy
+const Collision::Footprint& SensingIndex::ownFootprint(const Body& self, size_t slot) {
+  if (!frozen_) return footprint(self, slot);
+
+  const Entry& e = entries_[slot];
+  if (e.present && e.snap.sprite == self.sprite && e.snap.costume == self.costume &&
+      e.snap.side == self.side && e.snap.dir == self.dir) {
+    return snapFootprint(slot);
+  }
+
+  thread_local Entry scratch;
+  const Costume* c = self.sprite->costumeAt(self.costume);
+  const int costume = c ? (int)(c - self.sprite->costumes.data()) : -1;
+  const uint64_t rev = masks_ ? masks_->revision() : 0;
+  if (scratch.spriteId != self.sprite->id || scratch.costume != costume || scratch.maskRevision != rev ||
+      scratch.side != self.side || scratch.dir != self.dir) {
+    const CollisionMask* mask = (masks_ && c) ? masks_->find(c->imagePath) : nullptr;
+    Collision::build(scratch.fp, mask, self.side, self.dir);
+    scratch.spriteId = self.sprite->id;
+    scratch.costume = costume;
+    scratch.maskRevision = rev;
+    scratch.side = self.side;
+    scratch.dir = self.dir;
+  }
+  return scratch.fp;
+}
+
+bool SensingIndex::touching(const Project& project, size_t selfSlot, int targetId) {
+  ensureCurrent(project);
+  Body self;
+  if (!body(project, selfSlot, self) || !self.visible) return false;
+
+  const int sx = stagePixel(self.x);
+  const int sy = stagePixel(self.y);
+  const Collision::Footprint* mine = nullptr;
+
+  // a candidate can overlap us only in the cells our own bounds cover; each
+  // pair is tested once, in the first cell both ranges share
+  const auto& sprites = project.sprites();
+  const size_t spriteCount = sprites.size();
+  const Cells e = frozen_ ? cellsOf(self) : entries_[selfSlot].cells;
+  Body other;
+  for (int cy = e.cy0; cy <= e.cy1; ++cy) {
+    for (int cx = e.cx0; cx <= e.cx1; ++cx) {
+      for (uint32_t slot : buckets_[bucketOf(cx, cy)]) {
+        if (slot == selfSlot) continue;
+        const int id = slot < spriteCount ? sprites[slot].id : cloneParentOf(project, (uint32_t)(slot - spriteCount));
+        if (id != targetId) continue; // also skips deleted clones
+        const Cells& o = entries_[slot].cells;
+        if (cx != std::max(e.cx0, o.cx0) || cy != std::max(e.cy0, o.cy0)) continue;
+        if (frozen_) other = entries_[slot].snap;
+        else if (!body(project, slot, other)) continue;
+        if (!other.visible) continue;
+
+        if (!mine) mine = &ownFootprint(self, selfSlot);
+        const Collision::Footprint& theirs = frozen_ ? snapFootprint(slot) : footprint(other, slot);
+        if (Collision::overlap(*mine, sx, sy, theirs, stagePixel(other.x), stagePixel(other.y))) return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool SensingIndex::touchingPoint(const Project& project, size_t selfSlot, float x, float y) {
+  ensureCurrent(project);
+  Body self;
+  if (!body(project, selfSlot, self) || !self.visible) return false;
+
+  return Collision::contains(ownFootprint(self, selfSlot), stagePixel(self.x), stagePixel(self.y),
+                             stagePixel(x), stagePixel(y));
+}
+
+bool SensingIndex::touchingEdge(const Project& project, size_t selfSlot) {
+  ensureCurrent(project);
+  Body self;
+  if (!body(project, selfSlot, self)) return false;
+
+  const int sx = stagePixel(self.x);
+  const int sy = stagePixel(self.y);
+
+  // well inside the stage whatever the rotation: no footprint needed
+  const int r = Collision::extentFor(self.side);
+  if (sx - r > -240 && sx + r < 240 && sy - r > -180 && sy + r < 180) return false;
+
+  const Collision::Footprint& fp = ownFootprint(self, selfSlot);
+  if (fp.empty) return false;
+  return sx + fp.minX <= -240 || sx + fp.maxX >= 240 || sy + fp.minY <= -180 || sy + fp.maxY >= 180;
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "runtime/Collision.h"
+
+class Project;
+class CollisionMaskCache;
+struct Sprite;
+
+// Sprite collision for the sensing blocks.
+//
+// Broadphase: a spatial hash of sprite bounds over stage coordinates.
+// Runtime rebuilds it at the start of every tick (which picks up edits made
+// in the editor) and runners report their own moves with moved(), so queries
+// in the middle of a tick see current positions.
+//
+// Narrowphase: per-sprite Collision::Footprint built from the costume's
+// alpha mask (when the renderer has loaded it; otherwise the full costume
+// square) and rebuilt only when costume, size or direction change.
+//
+// Slots ("bodies") are the sprite slots followed by one per clone slot, see
+// cloneBody().
+//
+// Parallel passes: between freeze() and thaw() the index is a snapshot of
+// the last rebuild(). Queries may come from several threads; every other
+// body is seen as it was in the snapshot, the querying body as it is now.
+// moved() is ignored meanwhile; Runtime rebuilds before the next pass.
+class SensingIndex {
+public:
+  void setMasks(const CollisionMaskCache* masks) { masks_ = masks; }
+
+  static size_t cloneBody(const Project& project, uint32_t cloneSlot);
+
+  void rebuild(const Project& project);
+  void moved(const Project& project, size_t slot);
+
+  void freeze();
+  void thaw() { frozen_ = false; }
+  bool frozen() const { return frozen_; }
+
+  // sprite `id`'s position: live, or from the snapshot while frozen
+  bool spritePosition(const Project& project, int id, float& x, float& y) const;
+  // from the body in `selfSlot` (live) to sprite `targetId`, the same way;
+  // false if either is gone
+  bool distanceTo(const Project& project, size_t selfSlot, int targetId, float& d) const;
+
+  // does the body in `selfSlot` touch sprite `targetId` or one of its clones?
+  bool touching(const Project& project, size_t selfSlot, int targetId);
+  bool touchingPoint(const Project& project, size_t selfSlot, float x, float y);
+  bool touchingEdge(const Project& project, size_t selfSlot);
+
+private:
+  static constexpr float kCellSize = 64.0f;
+  static constexpr size_t kBuckets = 1024;    // power of two
+
+  // a sprite or clone as the index sees it; the clone's parent in `sprite`
+  struct Body {
+    const Sprite* sprite{nullptr};
+    float x{0}, y{0};
+    float dir{90};
+    float side{0};
+    int costume{0};
+    bool visible{false};
+  };
+
+  struct Cells {
+    int cx0{0}, cy0{0}, cx1{-1}, cy1{-1};
+  };
+
+  struct Entry {
+    Cells cells;                               // covered cell range
+    Body snap;                                 // as of the last rebuild()
+    bool present{false};
+
+    // what the footprint was built from
+    int spriteId{0};
+    int costume{-1};
+    uint64_t maskRevision{0};
+    float side{-1.0f};
+    float dir{0.0f};
+    Collision::Footprint fp;
+  };
+
+  static bool body(const Project& project, size_t slot, Body& out); // false: no such body
+  static int cloneParentOf(const Project& project, uint32_t cloneSlot); // 0: deleted
+
+  static int cellOf(float v);
+  static Cells cellsOf(const Body& b);
+  static size_t bucketOf(int cx, int cy);
+  static size_t bodyCount(const Project& project);
+  void insert(size_t slot, const Body& b);
+  void remove(size_t slot);
+  const Collision::Footprint& footprint(const Body& b, size_t slot);
+  const Collision::Footprint& ownFootprint(const Body& self, size_t slot);
+  const Collision::Footprint& snapFootprint(size_t slot);
+  void ensureCurrent(const Project& project);
+
+  const CollisionMaskCache* masks_{nullptr};
+  std::vector<Entry> entries_;                 // by body slot
+  std::vector<std::vector<uint32_t>> buckets_; // body slots per hashed cell
+
+  // while frozen, each snapshot footprint is checked/rebuilt by whichever
+  // query gets to it first
+  enum : uint8_t { kFpUnchecked, kFpBuilding, kFpReady };
+  bool frozen_{false};
+  std::unique_ptr<std::atomic<uint8_t>[]> fpState_; // by body slot
+  size_t fpStateSize_{0};
+};
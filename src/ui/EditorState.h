@@ -1,13 +1,28 @@
 #pragma once
 #include <cstdint>
 
+#include "model/Sprite.h"
+
+// The selected and dragged blocks are held as handles into their sprite's
+// BlockStore: once the block is deleted they stop resolving, even after its
+// slot is reused.
 struct EditorState {
-  int selectedBlockId{0};
+  int blockSpriteId{0};     // the sprite the handles below point into
+  BlockHandle selectedBlock;
   int selectedScriptId{0};
 
   // drag
   bool dragging{false};
-  int dragRootBlockId{0};  // block id که کلیک/drag ازش شروع شد
+  BlockHandle dragRoot;     // the block the click/drag started on
   float dragStartMouseX{0}, dragStartMouseY{0};
   float dragStartBlockX{0}, dragStartBlockY{0};
-};
\ No newline at end of file
+
+  // null: nothing selected/dragged in `sp`, or the block is gone
+  Block* selected(Sprite& sp) const { return sp.id == blockSpriteId ? sp.blocks.get(selectedBlock) : nullptr; }
+  Block* dragged(Sprite& sp) const { return sp.id == blockSpriteId ? sp.blocks.get(dragRoot) : nullptr; }
+
+  void select(const Sprite& sp, int blockId) {
+    blockSpriteId = sp.id;
+    selectedBlock = sp.blocks.handle(blockId); // invalid for 0 / no such block
+  }
+};
@@ -7,6 +7,7 @@
 
 #include "core/Logger.h"
 #include "core/Serialization.h"
+#include "core/Trace.h"
 
 #include "ui/Panels/StagePanel.h"
 #include "ui/Panels/SpritePanel.h"
@@ -16,6 +17,7 @@
 #include "ui/Panels/CostumesPanel.h"
 #include "ui/Panels/SoundsPanel.h"
 #include "ui/Panels/SettingsPanel.h"
+#include "ui/Panels/ProfilerPanel.h"
 #include "ui/Panels/ExtensionsPanel.h"
 #include "ui/Panels/HelpPanel.h"
 
@@ -33,6 +35,7 @@ MainDockspace::MainDockspace() {
 void MainDockspace::doNewProject() {
   if (!project_) return;
   project_->resetToDefault();
+  editor_ = EditorState{}; // ids and slots start over
   selectedSpriteId_ = project_->sprites().empty() ? 0 : project_->sprites().front().id;
   Logger::info("File", "New project created");
 }
@@ -63,6 +66,7 @@ void MainDockspace::doLoadProject(const std::string& path) {
     return;
   }
 
+  editor_ = EditorState{}; // ids and slots start over
   selectedSpriteId_ = project_->sprites().empty() ? 0 : project_->sprites().front().id;
   lastError_.clear();
   Logger::info("File", "Loaded: " + path);
@@ -263,6 +267,37 @@ void MainDockspace::drawMenuBar(Runtime& runtime) {
     }
     if (ImGui::MenuItem("Stop")) runtime.stopAll();
 
+    bool turbo = runtime.turbo();
+    if (ImGui::MenuItem("Turbo Mode", nullptr, &turbo)) runtime.setTurbo(turbo);
+    bool parallel = runtime.parallel();
+    if (ImGui::MenuItem("Parallel Mode", nullptr, &parallel)) runtime.setParallel(parallel);
+    ImGui::MenuItem("Profiler", nullptr, &showProfiler_);
+
+    // Chrome trace of the next frames (open in chrome://tracing or Perfetto)
+    ImGui::InputInt("Trace frames", &traceFrames_);
+    if (ImGui::MenuItem("Capture Trace", nullptr, false, !Trace::capturing())) {
+      Trace::capture(std::max(1, traceFrames_), "scratchy_trace.json");
+    }
+    if (Trace::capturing()) ImGui::Text("Tracing: %d frame(s) left", Trace::framesLeft());
+
+    // a run's input, to replay it (and profile it) without playing again
+    if (ImGui::MenuItem("Record Input Run", nullptr, false, project_ && !runtime.recordingInput())) {
+      runtime.recordInput("scratchy_input.rec");
+      runtime.startGreenFlag(*project_);
+    }
+    if (ImGui::MenuItem("Replay Input Run", nullptr, false, project_ != nullptr)) {
+      InputLog log;
+      std::string err;
+      if (log.load("scratchy_input.rec", &err)) {
+        runtime.replayInput(std::move(log));
+        runtime.startGreenFlag(*project_);
+      } else {
+        Logger::error("Input", "Can't replay scratchy_input.rec: " + err);
+      }
+    }
+    if (runtime.recordingInput()) ImGui::TextUnformatted("Recording input");
+    if (runtime.replayingInput()) ImGui::TextUnformatted("Replaying input");
+
     ImGui::Separator();
     ImGui::MenuItem("Step Mode", nullptr, &stepMode_);
     if (ImGui::MenuItem("Pause")) { runtime.setPaused(true); stepMode_ = false; }
@@ -276,6 +311,15 @@ void MainDockspace::drawMenuBar(Runtime& runtime) {
       }
     }
 
+    const auto& sched = runtime.schedulerStats();
+    if (sched.overloaded) {
+      ImGui::Separator();
+      ImGui::TextColored(ImVec4(1, 0.8f, 0.3f, 1), "Under load: %d of %d script(s) waiting", sched.starved, sched.runnable);
+      if (sched.maxStarvedTicks > 0) ImGui::Text("Longest wait: %d tick(s)", sched.maxStarvedTicks);
+      const auto& gov = runtime.governor();
+      ImGui::Text("Tick: %.1f ms avg, script budget at %d%%", gov.avgTickMillis(), (int)(gov.scale() * 100.0 + 0.5));
+    }
+
     if (!runtime.lastError().empty()) {
       ImGui::Separator();
       ImGui::TextColored(ImVec4(1, 0.3f, 0.3f, 1), "Runtime error:");
@@ -336,6 +380,7 @@ void MainDockspace::drawLayoutWindows(Renderer2D& renderer) {
   static CostumesPanel costumesPanel;
   static SoundsPanel soundsPanel;
   static SettingsPanel settingsPanel;
+  static ProfilerPanel profilerPanel;
   static ExtensionsPanel extensionsPanel;
   static HelpPanel helpPanel;
 
@@ -395,13 +440,15 @@ void MainDockspace::drawLayoutWindows(Renderer2D& renderer) {
     float centerW = (rightX - pad) - centerX;
     ImGui::SetNextWindowPos(ImVec2(centerX, topLeft.y), ImGuiCond_Always);
     ImGui::SetNextWindowSize(ImVec2(std::max(200.0f, centerW), usableH), ImGuiCond_Always);
-    workspacePanel.draw(*project_, selectedSpriteId_, &showWorkspace_, editor_);
+    workspacePanel.draw(*project_, selectedSpriteId_, &showWorkspace_, editor_,
+                        runtime_->profiling() ? &runtime_->profiler() : nullptr);
   }
 
   // Floating windows
   costumesPanel.draw(*project_, selectedSpriteId_, &showCostumes_);
   soundsPanel.draw(*project_, selectedSpriteId_, &showSounds_);
-  settingsPanel.draw(*project_, &showSettings_);
+  settingsPanel.draw(*project_, *runtime_, &showSettings_);
+  profilerPanel.draw(*project_, *runtime_, &showProfiler_);
   extensionsPanel.draw(*project_, &showExtensions_, &penEnabled_, selectedSpriteId_, &pen_);
   helpPanel.draw(&showHelp_);
 
@@ -421,6 +468,7 @@ void MainDockspace::drawLayoutWindows(Renderer2D& renderer) {
 // ---------------- Main draw ----------------
 void MainDockspace::draw(Project& project, Renderer2D& renderer, Runtime& runtime) {
   project_ = &project;
+  runtime_ = &runtime;
 
   // sync pen
   pen_.setEnabled(penEnabled_);
@@ -548,6 +596,23 @@ void MainDockspace::draw(Project& project, Renderer2D& renderer, Runtime& runtim
     ImGui::EndPopup();
   }
 
+  // Watchdog: a script ran too long without a yield point
+  if (runtime.watchdog().tripped()) {
+    ImGui::OpenPopup("Script not responding");
+  }
+  if (ImGui::BeginPopupModal("Script not responding", nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+    const auto& trip = runtime.watchdog().report();
+    ImGui::TextWrapped("%s", trip.message.c_str());
+    ImGui::Separator();
+    if (ImGui::Button("Stop this script")) runtime.stopTrippedScript();
+    ImGui::SameLine();
+    if (ImGui::Button("Keep running")) runtime.keepTrippedScript();
+    ImGui::SameLine();
+    if (ImGui::Button("Stop all")) runtime.stopAll();
+    if (!runtime.watchdog().tripped()) ImGui::CloseCurrentPopup(); // also cleared by Stop / Green Flag
+    ImGui::EndPopup();
+  }
+
 
   drawLayoutWindows(renderer);
 }
\ No newline at end of file
@@ -36,6 +36,7 @@ private:
 
 private:
   Project* project_ = nullptr;
+  Runtime* runtime_ = nullptr;
 
   // visibility toggles
   bool showStage_ = true;
@@ -48,6 +49,8 @@ private:
   bool showCostumes_ = false;
   bool showSounds_ = false;
   bool showSettings_ = false;
+  bool showProfiler_ = false;
+  int traceFrames_ = 120;
   bool showExtensions_ = false;
   bool showHelp_ = false;
 
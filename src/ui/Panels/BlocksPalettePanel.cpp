@@ -28,6 +28,9 @@ void BlocksPalettePanel::draw(Project&, bool* open) {
   ImGui::TextUnformatted("Events");
   DragBlock(BlockType::WhenGreenFlag, "when green flag clicked");
   DragBlock(BlockType::WhenKeyPressed, "when key pressed");
+  DragBlock(BlockType::WhenIReceive, "when I receive");
+  DragBlock(BlockType::Broadcast, "broadcast");
+  DragBlock(BlockType::BroadcastAndWait, "broadcast and wait");
   ImGui::Separator();
 
   // MOTION (BLUE)
@@ -89,6 +92,11 @@ void BlocksPalettePanel::draw(Project&, bool* open) {
   DragBlock(BlockType::StopThisScript, "stop this script");
   DragBlock(BlockType::StopAll,        "stop all");
 
+  ImGui::Separator();
+  DragBlock(BlockType::WhenIStartAsClone, "when I start as a clone");
+  DragBlock(BlockType::CreateCloneOf,     "create clone of (myself)");
+  DragBlock(BlockType::DeleteThisClone,   "delete this clone");
+
   ImGui::PopStyleColor(4);
 
   // ---- Sensing (AZURE) ----
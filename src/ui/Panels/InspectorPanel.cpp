@@ -2,23 +2,6 @@
 #include "imgui.h"
 #include "core/Logger.h"
 
-static const char* blockLabel(BlockType t) {
-  switch (t) {
-    case BlockType::WhenGreenFlag: return "when green flag clicked";
-    case BlockType::WhenKeyPressed: return "when key pressed";
-    case BlockType::MoveSteps: return "move steps";
-    case BlockType::TurnRight: return "turn right";
-    case BlockType::TurnLeft: return "turn left";
-    case BlockType::GoToXY: return "go to x y";
-    case BlockType::Say: return "say";
-    case BlockType::WaitSeconds: return "wait seconds";
-    case BlockType::Repeat: return "repeat (TODO)";
-    case BlockType::Forever: return "forever (TODO)";
-    case BlockType::IfThen: return "if then (TODO)";
-    default: return "block";
-  }
-}
-
 void InspectorPanel::draw(Project& project, int selectedSpriteId, EditorState& st) {
   ImGui::Begin("Inspector");
 
@@ -30,31 +13,29 @@ void InspectorPanel::draw(Project& project, int selectedSpriteId, EditorState& s
   }
 
   // --- Block inspector (if selected) ---
-  if (st.selectedBlockId != 0) {
-    Block* b = project.findBlock(*sp, st.selectedBlockId);
+  if (st.selectedBlock.valid()) {
+    Block* b = st.selected(*sp);
     if (b) {
       ImGui::Text("Block: %s", blockLabel(b->type));
       ImGui::Separator();
 
       // editable args based on type
       if (b->type == BlockType::MoveSteps || b->type == BlockType::TurnRight || b->type == BlockType::TurnLeft || b->type == BlockType::WaitSeconds) {
-        if (b->args.empty()) b->args = {"0"};
+        if (b->args.empty()) project.setBlockArg(*b, 0, "0");
         char buf[64]{};
         strncpy(buf, b->args[0].c_str(), sizeof(buf)-1);
         if (ImGui::InputText("Value", buf, sizeof(buf))) {
-          b->args[0] = buf;
-          project.markDirty();
+          project.setBlockArg(*b, 0, buf);
         }
       } else if (b->type == BlockType::Say || b->type == BlockType::Think || b->type == BlockType::AskAndWait) {
-        if (b->args.empty()) b->args = {"Hello!"};
+        if (b->args.empty()) project.setBlockArg(*b, 0, "Hello!");
         char buf[256]{};
         strncpy(buf, b->args[0].c_str(), sizeof(buf)-1);
         if (ImGui::InputTextMultiline("Text", buf, sizeof(buf), ImVec2(-1, 80))) {
-          b->args[0] = buf;
-          project.markDirty();
+          project.setBlockArg(*b, 0, buf);
         }
       } else if (b->type == BlockType::GoToXY) {
-        while (b->args.size() < 2) b->args.push_back("0");
+        while (b->args.size() < 2) project.setBlockArg(*b, b->args.size(), "0");
         char bx[64]{}, by[64]{};
         strncpy(bx, b->args[0].c_str(), sizeof(bx)-1);
         strncpy(by, b->args[1].c_str(), sizeof(by)-1);
@@ -62,10 +43,33 @@ void InspectorPanel::draw(Project& project, int selectedSpriteId, EditorState& s
         changed |= ImGui::InputText("X", bx, sizeof(bx));
         changed |= ImGui::InputText("Y", by, sizeof(by));
         if (changed) {
-          b->args[0] = bx;
-          b->args[1] = by;
-          project.markDirty();
+          project.setBlockArg(*b, 0, bx);
+          project.setBlockArg(*b, 1, by);
+        }
+      } else if (b->type == BlockType::WhenKeyPressed) {
+        if (b->args.empty()) project.setBlockArg(*b, 0, "space");
+        char buf[64]{};
+        strncpy(buf, b->args[0].c_str(), sizeof(buf)-1);
+        if (ImGui::InputText("Key", buf, sizeof(buf))) {
+          project.setBlockArg(*b, 0, buf);
+        }
+        ImGui::TextDisabled("a-z, 0-9, space, enter, up/down/left/right, any");
+      } else if (b->type == BlockType::WhenIReceive || b->type == BlockType::Broadcast ||
+                 b->type == BlockType::BroadcastAndWait) {
+        if (b->args.empty()) project.setBlockArg(*b, 0, "message1");
+        char buf[128]{};
+        strncpy(buf, b->args[0].c_str(), sizeof(buf)-1);
+        if (ImGui::InputText("Message", buf, sizeof(buf))) {
+          project.setBlockArg(*b, 0, buf);
+        }
+      } else if (b->type == BlockType::CreateCloneOf) {
+        if (b->args.empty()) project.setBlockArg(*b, 0, "myself");
+        char buf[128]{};
+        strncpy(buf, b->args[0].c_str(), sizeof(buf)-1);
+        if (ImGui::InputText("Of", buf, sizeof(buf))) {
+          project.setBlockArg(*b, 0, buf);
         }
+        ImGui::TextDisabled("myself, or a sprite name");
       } else {
         ImGui::TextDisabled("No editable args for this block yet.");
       }
@@ -80,8 +84,8 @@ void InspectorPanel::draw(Project& project, int selectedSpriteId, EditorState& s
       ImGui::End();
       return; // وقتی block انتخاب شده، تنظیمات sprite را پایین نشون نمی‌دیم
     } else {
-      // selected block invalid -> clear
-      st.selectedBlockId = 0;
+      // selected block gone (or in another sprite) -> clear
+      st.selectedBlock = {};
     }
   }
 
@@ -0,0 +1,106 @@
+#include "ui/Panels/ProfilerPanel.h"
+#include "imgui.h"
+
+#include <algorithm>
+
+void ProfilerPanel::buildRows(const Project& project, const Profiler& prof) {
+  auto spriteName = [&](int id) {
+    const Sprite* sp = project.findSpriteById(id);
+    return sp ? sp->name : std::string("?");
+  };
+
+  rows_.clear();
+  switch (view_) {
+    case View::Blocks:
+      for (const auto& b : prof.blocks()) {
+        rows_.push_back({std::string(blockLabel(b.type)) + " #" + std::to_string(b.blockId), spriteName(b.spriteId),
+                         b.count, b.selfNs, b.totalNs});
+      }
+      break;
+    case View::Types:
+      prof.types(types_);
+      for (const auto& t : types_) rows_.push_back({blockLabel(t.type), "-", t.count, t.ns, t.ns});
+      break;
+    case View::Scripts:
+      for (const auto& s : prof.scripts()) {
+        rows_.push_back({"script " + std::to_string(s.scriptId), spriteName(s.spriteId), s.count, s.ns, s.ns});
+      }
+      break;
+  }
+}
+
+void ProfilerPanel::draw(const Project& project, Runtime& runtime, bool* open) {
+  if (!open || !*open) return;
+  ImGui::Begin("Profiler", open);
+
+  bool on = runtime.profiling();
+  if (ImGui::Checkbox("Profile scripts", &on)) runtime.setProfiling(on);
+  ImGui::SameLine();
+  if (ImGui::Button("Reset")) runtime.profiler().reset();
+
+  const Profiler& prof = runtime.profiler();
+  const double totalMs = prof.totalNs() / 1.0e6;
+  ImGui::Text("Sampled script time: %.1f ms", totalMs);
+  if (!on) ImGui::TextDisabled("Turn profiling on and run the project to see where script time goes.");
+
+  if (ImGui::RadioButton("Blocks", view_ == View::Blocks)) view_ = View::Blocks;
+  ImGui::SameLine();
+  if (ImGui::RadioButton("Block types", view_ == View::Types)) view_ = View::Types;
+  ImGui::SameLine();
+  if (ImGui::RadioButton("Scripts", view_ == View::Scripts)) view_ = View::Scripts;
+  ImGui::Separator();
+
+  buildRows(project, prof);
+
+  const ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+                                ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+  if (ImGui::BeginTable("profile", 6, flags)) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn(view_ == View::Types ? "Type" : view_ == View::Scripts ? "Script" : "Block");
+    ImGui::TableSetupColumn("Sprite");
+    ImGui::TableSetupColumn("Count", ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableSetupColumn("Self ms", ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableSetupColumn("Total ms", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableSetupColumn("% of time", ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableHeadersRow();
+
+    // rows change every tick, so sort every frame
+    int column = 4;
+    bool ascending = false;
+    if (ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs(); specs && specs->SpecsCount > 0) {
+      column = specs->Specs[0].ColumnIndex;
+      ascending = specs->Specs[0].SortDirection == ImGuiSortDirection_Ascending;
+      specs->SpecsDirty = false;
+    }
+    auto less = [column](const Row& a, const Row& b) {
+      switch (column) {
+        case 0: return a.name < b.name;
+        case 1: return a.sprite < b.sprite;
+        case 2: return a.count < b.count;
+        case 3: return a.selfNs < b.selfNs;
+        default: return a.totalNs < b.totalNs; // total and %
+      }
+    };
+    std::stable_sort(rows_.begin(), rows_.end(),
+                     [&](const Row& a, const Row& b) { return ascending ? less(a, b) : less(b, a); });
+
+    for (const Row& r : rows_) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(r.name.c_str());
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(r.sprite.c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", (unsigned long long)r.count);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", r.selfNs / 1.0e6);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", r.totalNs / 1.0e6);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f%%", prof.totalNs() ? 100.0 * r.totalNs / prof.totalNs() : 0.0);
+    }
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "core/Project.h"
+#include "runtime/Runtime.h"
+
+// Where script time goes: Runtime's profiler per block, per block type or
+// per script, in a sortable table.
+class ProfilerPanel {
+public:
+  void draw(const Project& project, Runtime& runtime, bool* open);
+
+private:
+  enum class View { Blocks, Types, Scripts };
+  struct Row {
+    std::string name;
+    std::string sprite;
+    uint64_t count{0};
+    uint64_t selfNs{0};
+    uint64_t totalNs{0};
+  };
+
+  void buildRows(const Project& project, const Profiler& prof);
+
+  View view_ = View::Blocks;
+  std::vector<Row> rows_;
+  std::vector<Profiler::TypeStats> types_;
+};
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "imgui.h"
 #include "core/Logger.h"
 #include <cmath>
+#include <cstdio>
 #include <string>
 #include <algorithm>
 
@@ -11,57 +12,6 @@ static const float BLOCK_H = 40.0f;
 static const float BLOCK_STEP_Y = 60.0f;
 static const float SNAP = 18.0f;
 
-static const char* blockLabel(BlockType t) {
-  switch (t) {
-    case BlockType::WhenGreenFlag: return "when green flag clicked";
-    case BlockType::WhenKeyPressed: return "when key pressed";
-    case BlockType::MoveSteps: return "move steps";
-    case BlockType::TurnRight: return "turn right";
-    case BlockType::TurnLeft: return "turn left";
-    case BlockType::GoToXY: return "go to x y";
-    case BlockType::Say: return "say";
-    case BlockType::WaitSeconds: return "wait seconds";
-    case BlockType::WaitUntil: return "wait until";
-    case BlockType::Repeat: return "repeat";
-    case BlockType::RepeatUntil: return "repeat until";
-    case BlockType::Forever: return "forever";
-    case BlockType::IfThen: return "if then";
-    case BlockType::StopThisScript: return "stop this script";
-    case BlockType::StopAll: return "stop all";
-    case BlockType::AskAndWait: return "ask and wait";
-    case BlockType::SetX: return "set x to";
-    case BlockType::SetY: return "set y to";
-    case BlockType::ChangeXBy: return "change x by";
-    case BlockType::ChangeYBy: return "change y by";
-    case BlockType::GoToRandomPosition: return "go to random";
-    case BlockType::GoToMousePointer: return "go to mouse";
-    case BlockType::IfOnEdgeBounce: return "if on edge bounce";
-    case BlockType::StopAtEdge: return "stop at edge";
-    case BlockType::Think: return "think";
-    case BlockType::SwitchCostumeTo: return "switch costume to";
-    case BlockType::NextCostume: return "next costume";
-    case BlockType::SwitchBackdropTo: return "switch backdrop to";
-    case BlockType::NextBackdrop: return "next backdrop";
-    case BlockType::SetSizeTo: return "set size to";
-    case BlockType::ChangeSizeBy: return "change size by";
-    case BlockType::Show: return "show";
-    case BlockType::Hide: return "hide";
-    case BlockType::GoToFrontLayer: return "go to front layer";
-    case BlockType::GoBackLayers: return "go back layers";
-    case BlockType::LooksReporter: return "looks report";
-
-    // Sound
-    case BlockType::PlaySound: return "play sound";
-    case BlockType::PlaySoundUntilDone: return "play sound until done";
-    case BlockType::StopAllSounds: return "stop all sounds";
-    case BlockType::SetVolumeTo: return "set volume to";
-    case BlockType::ChangeVolumeBy: return "change volume by";
-    case BlockType::SetPitchTo: return "set pitch to";
-    case BlockType::ChangePitchBy: return "change pitch by";
-    default: return "block";
-  }
-}
-
 static bool isControl(BlockType t) {
   return (t == BlockType::Repeat || t == BlockType::RepeatUntil || t == BlockType::Forever || t == BlockType::IfThen);
 }
@@ -69,8 +19,7 @@ static bool isControl(BlockType t) {
 // -------------------- Hit Tests --------------------
 
 int ScriptWorkspacePanel::hitTestBlock(const Sprite& sp, float localX, float localY) const {
-  for (const auto& kv : sp.blocks) {
-    const Block& b = kv.second;
+  for (const Block& b : sp.blocks) {
     if (localX >= b.x && localX <= b.x + BLOCK_W &&
         localY >= b.y && localY <= b.y + BLOCK_H) {
       return b.id;
@@ -83,22 +32,22 @@ int ScriptWorkspacePanel::hitTestTail(const Sprite& sp, float localX, float loca
   // detect drop near bottom "connector" of last block in each script
   for (const auto& sc : sp.scripts) {
     int cur = sc.headBlockId;
-    int safety = 0;
+    size_t hops = 0; // bounded by the block count in case a broken file has a cycle
     int last = -1;
 
-    while (cur != -1 && safety++ < 2000) {
-      auto it = sp.blocks.find(cur);
-      if (it == sp.blocks.end()) break;
+    while (cur != -1 && hops++ < sp.blocks.size()) {
+      const Block* b = sp.blocks.find(cur);
+      if (!b) break;
       last = cur;
-      cur = it->second.nextId;
+      cur = b->nextId;
     }
     if (last == -1) continue;
 
-    auto itLast = sp.blocks.find(last);
-    if (itLast == sp.blocks.end()) continue;
+    const Block* lastB = sp.blocks.find(last);
+    if (!lastB) continue;
 
-    float cx = itLast->second.x + BLOCK_W * 0.5f;
-    float cy = itLast->second.y + BLOCK_H; // bottom
+    float cx = lastB->x + BLOCK_W * 0.5f;
+    float cy = lastB->y + BLOCK_H; // bottom
 
     if (std::fabs(localX - cx) <= SNAP && std::fabs(localY - cy) <= SNAP) {
       return last;
@@ -113,12 +62,12 @@ float ScriptWorkspacePanel::chainHeight(const Sprite& sp, int headId) const {
 
   float h = 0.0f;
   int cur = headId;
-  int safety = 0;
-  while (cur != -1 && safety++ < 5000) {
-    auto it = sp.blocks.find(cur);
-    if (it == sp.blocks.end()) break;
+  size_t hops = 0;
+  while (cur != -1 && hops++ < sp.blocks.size()) {
+    const Block* bp = sp.blocks.find(cur);
+    if (!bp) break;
 
-    const Block& b = it->second;
+    const Block& b = *bp;
     h += BLOCK_STEP_Y;
 
     if (b.childHeadId != -1) {
@@ -134,8 +83,7 @@ float ScriptWorkspacePanel::chainHeight(const Sprite& sp, int headId) const {
 int ScriptWorkspacePanel::hitTestControlBody(const Sprite& sp, float localX, float localY) const {
   const float HEADER_H = BLOCK_H;
 
-  for (const auto& kv : sp.blocks) {
-    const Block& b = kv.second;
+  for (const Block& b : sp.blocks) {
     if (!isControl(b.type)) continue;
 
     float bodyH = chainHeight(sp, b.childHeadId);
@@ -158,25 +106,26 @@ int ScriptWorkspacePanel::hitTestControlBody(const Sprite& sp, float localX, flo
 
 void ScriptWorkspacePanel::moveStackRecursive(Sprite& sp, int rootBlockId, float dx, float dy) {
   int cur = rootBlockId;
-  int safety = 0;
-  while (cur != -1 && safety++ < 8000) {
-    auto it = sp.blocks.find(cur);
-    if (it == sp.blocks.end()) break;
+  size_t hops = 0;
+  while (cur != -1 && hops++ < sp.blocks.size()) {
+    Block* b = sp.blocks.find(cur);
+    if (!b) break;
 
-    it->second.x += dx;
-    it->second.y += dy;
+    b->x += dx;
+    b->y += dy;
 
-    if (it->second.childHeadId != -1) {
-      moveStackRecursive(sp, it->second.childHeadId, dx, dy);
+    if (b->childHeadId != -1) {
+      moveStackRecursive(sp, b->childHeadId, dx, dy);
     }
 
-    cur = it->second.nextId;
+    cur = b->nextId;
   }
 }
 
 // -------------------- Main Draw --------------------
 
-void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* open, EditorState& st) {
+void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* open, EditorState& st,
+                                const Profiler* profile) {
   if (!open || !*open) return;
   ImGui::Begin("Script Workspace", open);
 
@@ -214,7 +163,7 @@ void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* op
   if (hovered && ImGui::IsMouseClicked(ImGuiMouseButton_Right)) {
     int hit = hitTestBlock(*sp, localX, localY);
     if (hit != 0) {
-      st.selectedBlockId = hit;
+      st.select(*sp, hit);
       ImGui::OpenPopup("BlockContext");
     } else {
       ImGui::OpenPopup("CanvasContext");
@@ -228,31 +177,31 @@ void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* op
     if (ImGui::MenuItem("New Script (Key Press)")) {
       project.createScript(*sp, localX, localY, BlockType::WhenKeyPressed);
     }
+    if (ImGui::MenuItem("New Script (When I Receive)")) {
+      project.createScript(*sp, localX, localY, BlockType::WhenIReceive);
+    }
+    if (ImGui::MenuItem("New Script (When I Start as a Clone)")) {
+      project.createScript(*sp, localX, localY, BlockType::WhenIStartAsClone);
+    }
     ImGui::EndPopup();
   }
 
   if (ImGui::BeginPopup("BlockContext")) {
     if (ImGui::MenuItem("Delete Block")) {
-      if (st.selectedBlockId != 0) {
-        project.deleteBlock(*sp, st.selectedBlockId);
-        st.selectedBlockId = 0;
-      }
+      if (const Block* sel = st.selected(*sp)) project.deleteBlock(*sp, sel->id);
     }
 
     // اگر hat بود، اجازه حذف script
-    Block* b = (st.selectedBlockId ? project.findBlock(*sp, st.selectedBlockId) : nullptr);
-    bool hat = b && (b->type == BlockType::WhenGreenFlag || b->type == BlockType::WhenKeyPressed);
+    Block* b = st.selected(*sp);
+    bool hat = b && isHatBlock(b->type);
 
     if (!hat) ImGui::BeginDisabled();
     if (ImGui::MenuItem("Delete Script")) {
       int sid = 0;
       for (auto& sc : sp->scripts) {
-        if (sc.headBlockId == st.selectedBlockId) sid = sc.id;
-      }
-      if (sid != 0) {
-        project.deleteScript(*sp, sid);
-        st.selectedBlockId = 0;
+        if (b && sc.headBlockId == b->id) sid = sc.id;
       }
+      if (sid != 0) project.deleteScript(*sp, sid);
     }
     if (!hat) ImGui::EndDisabled();
 
@@ -262,11 +211,11 @@ void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* op
   // -------------------- Left click: select + start drag --------------------
   if (hovered && ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
     int hit = hitTestBlock(*sp, localX, localY);
-    st.selectedBlockId = hit;
+    st.select(*sp, hit);
 
     if (hit != 0) {
       st.dragging = true;
-      st.dragRootBlockId = hit;
+      st.dragRoot = st.selectedBlock;
       st.dragStartMouseX = localX;
       st.dragStartMouseY = localY;
 
@@ -279,7 +228,7 @@ void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* op
   // -------------------- Drag move --------------------
   if (st.dragging) {
     if (ImGui::IsMouseDown(ImGuiMouseButton_Left)) {
-      Block* bb = project.findBlock(*sp, st.dragRootBlockId);
+      Block* bb = st.dragged(*sp);
       if (bb) {
         float dx = localX - st.dragStartMouseX;
         float dy = localY - st.dragStartMouseY;
@@ -290,46 +239,37 @@ void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* op
         float ddx = newX - bb->x;
         float ddy = newY - bb->y;
 
-        moveStackRecursive(*sp, st.dragRootBlockId, ddx, ddy);
+        moveStackRecursive(*sp, bb->id, ddx, ddy);
         project.markDirty();
       }
     } else {
       // mouse released: snap connect to tail if close
       int tail = hitTestTail(*sp, localX, localY);
-      if (tail != 0 && st.dragRootBlockId != 0 && tail != st.dragRootBlockId) {
+      const Block* dragged = st.dragged(*sp);
+      const int rootId = dragged ? dragged->id : 0;
+      if (tail != 0 && rootId != 0 && tail != rootId) {
 
-        // detach dragged root from previous chain
-        int prev = project.findPrevInAnyChain(*sp, st.dragRootBlockId);
-        if (prev != -1) {
-          Block* pb = project.findBlock(*sp, prev);
-          if (pb) pb->nextId = -1;
-        } else {
-          // if it was a script head, detach by clearing head
-          for (auto& sc : sp->scripts) {
-            if (sc.headBlockId == st.dragRootBlockId) {
-              sc.headBlockId = -1; // simple detach; later we can prune empty scripts
-            }
-          }
-        }
+        // detach dragged root from previous chain (or script head / body)
+        project.unlinkStack(*sp, rootId);
 
         // connect tail -> draggedRoot
-        project.linkAfter(*sp, tail, st.dragRootBlockId);
+        project.linkAfter(*sp, tail, rootId);
 
         // align position under tail
         Block* tb = project.findBlock(*sp, tail);
-        Block* rb = project.findBlock(*sp, st.dragRootBlockId);
+        Block* rb = project.findBlock(*sp, rootId);
         if (tb && rb) {
           float targetX = tb->x;
           float targetY = tb->y + BLOCK_STEP_Y;
           float dx = targetX - rb->x;
           float dy = targetY - rb->y;
-          moveStackRecursive(*sp, st.dragRootBlockId, dx, dy);
+          moveStackRecursive(*sp, rootId, dx, dy);
           project.markDirty();
         }
       }
 
       st.dragging = false;
-      st.dragRootBlockId = 0;
+      st.dragRoot = {};
     }
   }
 
@@ -340,8 +280,7 @@ void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* op
 
       // 1) If dropped inside a control-body => append to child chain
       int bodyOwner = hitTestControlBody(*sp, localX, localY);
-      if (bodyOwner != 0 &&
-          t != BlockType::WhenGreenFlag && t != BlockType::WhenKeyPressed) {
+      if (bodyOwner != 0 && !isHatBlock(t)) {
 
         Block* owner = project.findBlock(*sp, bodyOwner);
         if (owner) {
@@ -351,9 +290,9 @@ void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* op
 
           // IMPORTANT: requires Project::appendToChain
           int newId = project.appendToChain(*sp, owner->childHeadId, t,
-                                            px, py + offsetY - 60.0f);
+                                            px, py + offsetY - 60.0f, owner->id);
 
-          st.selectedBlockId = newId;
+          st.select(*sp, newId);
           project.markDirty();
         }
 
@@ -364,7 +303,7 @@ void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* op
       }
 
       // 2) If hat => create new script
-      if (t == BlockType::WhenGreenFlag || t == BlockType::WhenKeyPressed) {
+      if (isHatBlock(t)) {
         project.createScript(*sp, localX, localY, t);
       } else {
         // 3) Normal: append to selected script (or create if none)
@@ -392,27 +331,43 @@ void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* op
               ImVec2(canvasPos.x + canvasSize.x, canvasPos.y + canvasSize.y),
               IM_COL32(120,120,120,255));
 
-  auto drawOneBlock = [&](const Block& b, const ImVec2& basePos, EditorState& stRef, const Sprite& spRef) {
+  const Block* selectedBlock = st.selected(*sp);
+  const int selectedId = selectedBlock ? selectedBlock->id : 0;
+
+  auto drawOneBlock = [&](const Block& b, const ImVec2& basePos, const Sprite& spRef) {
     ImVec2 p0(basePos.x + b.x, basePos.y + b.y);
     ImVec2 p1(basePos.x + b.x + BLOCK_W, basePos.y + b.y + BLOCK_H);
 
     ImU32 col = IM_COL32(70, 130, 220, 255);
-    if (b.type == BlockType::WhenGreenFlag || b.type == BlockType::WhenKeyPressed) col = IM_COL32(230, 180, 40, 255);
+    if (isHatBlock(b.type) || b.type == BlockType::Broadcast || b.type == BlockType::BroadcastAndWait)
+      col = IM_COL32(230, 180, 40, 255);
     if (b.type == BlockType::Say) col = IM_COL32(160, 90, 190, 255);
-    if (b.type == BlockType::WaitSeconds || isControl(b.type))
+    if (b.type == BlockType::WaitSeconds || isControl(b.type) || b.type == BlockType::CreateCloneOf ||
+        b.type == BlockType::WhenIStartAsClone || b.type == BlockType::DeleteThisClone)
       col = IM_COL32(230, 140, 50, 255);
     if (b.type == BlockType::PlaySound || b.type == BlockType::PlaySoundUntilDone || b.type == BlockType::StopAllSounds ||
         b.type == BlockType::SetVolumeTo || b.type == BlockType::ChangeVolumeBy ||
         b.type == BlockType::SetPitchTo || b.type == BlockType::ChangePitchBy)
       col = IM_COL32(220, 80, 150, 255);
 
-    bool selected = (stRef.selectedBlockId == b.id);
+    bool selected = (b.id == selectedId);
     if (selected) {
       dl->AddRectFilled(ImVec2(p0.x-2, p0.y-2), ImVec2(p1.x+2, p1.y+2),
                         IM_COL32(255,255,255,140), 8.0f);
     }
 
     dl->AddRectFilled(p0, p1, col, 6.0f);
+
+    // profiler heatmap: red by own time, share of all script time (loops:
+    // with their body) on the right
+    const Profiler::BlockStats* heat = profile ? profile->block(b.id) : nullptr;
+    if (heat && profile->totalNs() > 0) {
+      float h = profile->maxSelfNs() ? (float)heat->selfNs / (float)profile->maxSelfNs() : 0.0f;
+      dl->AddRectFilled(p0, p1, IM_COL32(255, 30, 30, (int)(30 + 170 * h)), 6.0f);
+      char pct[16];
+      std::snprintf(pct, sizeof(pct), "%.1f%%", 100.0 * heat->totalNs / profile->totalNs());
+      dl->AddText(ImVec2(p1.x - 48, p0.y + 12), IM_COL32(255,255,255,255), pct);
+    }
     dl->AddRect(p0, p1, IM_COL32(20,20,20,255), 6.0f);
 
     std::string text = blockLabel(b.type);
@@ -442,24 +397,24 @@ void ScriptWorkspacePanel::draw(Project& project, int selectedSpriteId, bool* op
   // draw top-level scripts
   for (const auto& sc : sp->scripts) {
     int cur = sc.headBlockId;
-    int safety = 0;
-    while (cur != -1 && safety++ < 5000) {
-      auto itb = sp->blocks.find(cur);
-      if (itb == sp->blocks.end()) break;
-      const Block& b = itb->second;
+    size_t hops = 0;
+    while (cur != -1 && hops++ < sp->blocks.size()) {
+      const Block* bp = sp->blocks.find(cur);
+      if (!bp) break;
+      const Block& b = *bp;
 
-      drawOneBlock(b, canvasPos, st, *sp);
+      drawOneBlock(b, canvasPos, *sp);
 
       // draw child chain if any
       if (b.childHeadId != -1) {
         int ccur = b.childHeadId;
-        int csafe = 0;
-        while (ccur != -1 && csafe++ < 5000) {
-          auto itc = sp->blocks.find(ccur);
-          if (itc == sp->blocks.end()) break;
-          const Block& cb = itc->second;
+        size_t chops = 0;
+        while (ccur != -1 && chops++ < sp->blocks.size()) {
+          const Block* cbp = sp->blocks.find(ccur);
+          if (!cbp) break;
+          const Block& cb = *cbp;
 
-          drawOneBlock(cb, canvasPos, st, *sp);
+          drawOneBlock(cb, canvasPos, *sp);
 
           ccur = cb.nextId;
         }
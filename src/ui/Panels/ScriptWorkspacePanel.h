@@ -1,11 +1,14 @@
 #pragma once
 #include "core/Project.h"
 #include "model/Block.h"
+#include "runtime/Profiler.h"
 #include "ui/EditorState.h"
 
 class ScriptWorkspacePanel {
 public:
-  void draw(Project& project, int selectedSpriteId, bool* open, EditorState& st);
+  // `profile`: tint blocks by the script time they took (null: no heatmap)
+  void draw(Project& project, int selectedSpriteId, bool* open, EditorState& st,
+            const Profiler* profile = nullptr);
 
 private:
   int hitTestBlock(const Sprite& sp, float localX, float localY) const;
@@ -1,7 +1,10 @@
 #include "ui/Panels/SettingsPanel.h"
 #include "imgui.h"
 
-void SettingsPanel::draw(Project& project, bool* open) {
+#include <algorithm>
+#include <cstdint>
+
+void SettingsPanel::draw(Project& project, Runtime& runtime, bool* open) {
   if (!open || !*open) return;
 
   ImGui::Begin("Settings", open);
@@ -11,5 +14,45 @@ void SettingsPanel::draw(Project& project, bool* open) {
   ImGui::Text("Backdrops: %d", (int)project.stage().backdrops.size());
   ImGui::Text("Current backdrop: %d", project.stage().currentBackdrop);
 
+  // InputInt keeps it to 31 bits; files and the CLI take any 64-bit seed
+  int seed = (int)std::min<uint64_t>(project.randomSeed(), INT32_MAX);
+  if (ImGui::InputInt("Random seed", &seed) && seed >= 0) {
+    project.setRandomSeed((uint64_t)seed);
+    project.markDirty();
+  }
+  ImGui::TextDisabled("0: new random numbers every run. Otherwise every run picks the same ones.");
+  if (runtime.randomSeed()) ImGui::Text("Last run's seed: %llu", (unsigned long long)runtime.randomSeed());
+
+  ImGui::Separator();
+  ImGui::TextUnformatted("Simulation");
+  auto& step = runtime.fixedStep().config();
+  if (ImGui::InputInt("Ticks per second", &step.ticksPerSecond)) {
+    step.ticksPerSecond = std::clamp(step.ticksPerSecond, 1, 1000);
+  }
+  if (ImGui::InputInt("Catch-up ticks per frame", &step.maxTicksPerFrame)) {
+    step.maxTicksPerFrame = std::clamp(step.maxTicksPerFrame, 1, 100);
+  }
+  ImGui::TextDisabled("Scratch runs at 30. Frames slower than the catch-up limit slow the project down.");
+  ImGui::Text("Dropped ticks: %llu", (unsigned long long)runtime.fixedStep().droppedTicks());
+
+  // script limits; Runtime clamps them to sane ranges every tick
+  ImGui::Separator();
+  ImGui::TextUnformatted("Script limits");
+  auto& safety = runtime.safety();
+  ImGui::InputInt("Steps per script per tick", &safety.maxStepsPerRunnerPerTick);
+  ImGui::InputInt("Steps per tick", &safety.maxTotalStepsPerTick);
+  ImGui::InputInt("Target tick (ms)", &safety.targetTickMillis);
+  ImGui::InputInt("Max tick (ms)", &safety.maxTickMillis);
+  ImGui::InputInt("Turbo frame (ms)", &safety.turboTickMillis);
+
+  ImGui::Separator();
+  ImGui::TextUnformatted("Watchdog");
+  auto& limits = runtime.watchdog().limits();
+  if (ImGui::InputInt("Time without a yield (ms)", &limits.unyieldedMillis, 100, 1000)) {
+    limits.unyieldedMillis = std::max(100, limits.unyieldedMillis);
+  }
+  ImGui::TextDisabled("A script that runs this long without reaching a loop end or wait is paused.");
+  ImGui::Text("Last frame: %u step(s)", runtime.watchdog().lastFrameInstructions());
+
   ImGui::End();
 }
\ No newline at end of file
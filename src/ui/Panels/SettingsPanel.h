@@ -1,7 +1,8 @@
 #pragma once
 #include "core/Project.h"
+#include "runtime/Runtime.h"
 
 class SettingsPanel {
 public:
-  void draw(Project& project, bool* open);
+  void draw(Project& project, Runtime& runtime, bool* open);
 };
\ No newline at end of file
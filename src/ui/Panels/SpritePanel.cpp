@@ -15,9 +15,8 @@ void SpritePanel::draw(Project& project) {
     Sprite sp;
     sp.id = project.allocSpriteId();
     sp.name = "Sprite" + std::to_string(sp.id);
-    project.sprites().push_back(sp);
+    project.addSprite(sp);
     selectedId_ = sp.id;
-    project.markDirty();
     Logger::info("Sprite", "Added sprite id=" + std::to_string(sp.id));
   }
 
@@ -27,12 +26,9 @@ void SpritePanel::draw(Project& project) {
   bool canRemove = selectedId_ != 0 && (int)project.sprites().size() > 1;
   if (!canRemove) ImGui::BeginDisabled();
   if (ImGui::Button("Remove")) {
-    auto& v = project.sprites();
-    v.erase(std::remove_if(v.begin(), v.end(),
-      [&](const Sprite& s){ return s.id == selectedId_; }), v.end());
-    project.markDirty();
+    project.removeSprite(selectedId_);
     Logger::warn("Sprite", "Removed selected sprite");
-    selectedId_ = v.empty() ? 0 : v.front().id;
+    selectedId_ = project.sprites().empty() ? 0 : project.sprites().front().id;
   }
   if (!canRemove) ImGui::EndDisabled();
 
@@ -49,10 +45,7 @@ void SpritePanel::draw(Project& project) {
   if (selectedId_ == 0 && !project.sprites().empty())
     selectedId_ = project.sprites().front().id;
 
-  bool found = false;
-  for (auto& sp : project.sprites()) {
-    if (sp.id == selectedId_) { found = true; break; }
-  }
+  bool found = project.findSpriteById(selectedId_) != nullptr;
   if ((!found || selectedId_ == 0) && !project.sprites().empty()) {
     selectedId_ = project.sprites().front().id;
   }